@@ -0,0 +1,315 @@
+#!/usr/bin/env python3
+#
+# Hotness-driven fxdata layout repacker.
+#
+# Reads an FX access trace (built with ARDULIB_FX_TRACE, see lib/include/FxTrace.h),
+# works out which images are drawn in the same frames and reorders the image_t
+# declarations of images.txt so co-accessed images share page-aligned runs.
+# A run is padded to a page boundary only when that saves a page.
+# Everything else in fxdata.txt keeps its order, so pointer tables that refer
+# to images are rebuilt by fxdata-build.py with the new offsets.
+#
+# Run from the fxdata folder:
+#
+#   python3 scripts/fxrepack.py fxtrace.bin                 # report only
+#   python3 scripts/fxrepack.py fxtrace.bin --write         # + fxdata-repacked.txt / images-repacked.txt
+#   python3 scripts/fxrepack.py fxtrace.bin --build         # + fxdata-repacked.bin / .h
+#   python3 scripts/fxrepack.py fxtrace.bin --install       # + copy over fxdata.h and ../assets/POA/fxdata.bin
+#
+# The report compares distinct pages touched per frame for the current layout
+# and the estimated repacked layout.
+
+import argparse
+import bisect
+import os
+import re
+import shutil
+import struct
+import subprocess
+import sys
+
+TRACE_MAGIC = b'FXTR'
+TRACE_VERSION = 1
+TRACE_HEADER = 8
+TRACE_RECORD = 9
+
+IMAGE_LINE = re.compile(r'^\s*image_t\s+(\w+)\s*=')
+SYMBOL_LINE = re.compile(r'^\s*constexpr\s+uint24_t\s+(\w+)\s*=\s*(0x[0-9A-Fa-f]+|\d+)\s*;')
+
+
+def read_symbols(header):
+    """Offsets of every data label in fxdata.h, sorted, plus the data size."""
+    symbols = []
+    data_bytes = None
+    with open(header) as f:
+        for line in f:
+            m = SYMBOL_LINE.match(line)
+            if not m:
+                continue
+            name, value = m.group(1), int(m.group(2), 0)
+            if name == 'FX_DATA_BYTES':
+                data_bytes = value
+            elif name.startswith('FX_'):
+                continue
+            else:
+                symbols.append((value, name))
+    symbols.sort()
+    if data_bytes is None:
+        data_bytes = symbols[-1][0] if symbols else 0
+    return symbols, data_bytes
+
+
+def read_trace(path):
+    with open(path, 'rb') as f:
+        data = f.read()
+    if data[:4] != TRACE_MAGIC or data[4] != TRACE_VERSION or data[5] != TRACE_RECORD:
+        sys.exit('{}: not an FX trace v{}'.format(path, TRACE_VERSION))
+    records = []
+    epoch = 0
+    last = 0
+    for i in range(TRACE_HEADER, len(data) - TRACE_RECORD + 1, TRACE_RECORD):
+        a0, a1, a2, length, frame, kind, tag = struct.unpack_from('<BBBHHBB', data, i)
+        if frame < last:
+            epoch += 0x10000
+        last = frame
+        records.append((a0 | (a1 << 8) | (a2 << 16), length, epoch + frame))
+    return records
+
+
+def read_images(images_txt):
+    with open(images_txt) as f:
+        lines = f.read().splitlines()
+    order = []
+    decl = {}
+    for line in lines:
+        m = IMAGE_LINE.match(line)
+        if m:
+            order.append(m.group(1))
+            decl[m.group(1)] = line.strip()
+    return order, decl
+
+
+class Layout:
+    def __init__(self, symbols, data_bytes):
+        self.offsets = [o for o, _ in symbols]
+        self.names = [n for _, n in symbols]
+        self.start = {n: o for o, n in symbols}
+        self.size = {}
+        for i, (o, n) in enumerate(symbols):
+            end = symbols[i + 1][0] if i + 1 < len(symbols) else data_bytes
+            # Labels that share an offset (aliases) get the span of the last one.
+            self.size[n] = end - o
+
+    def symbol_at(self, addr):
+        i = bisect.bisect_right(self.offsets, addr) - 1
+        while i > 0 and self.offsets[i - 1] == self.offsets[i]:
+            i -= 1
+        return self.names[i] if i >= 0 else None
+
+
+def frames_by_symbol(records, layout):
+    """frame -> {symbol: [(offset_in_symbol, length)]}"""
+    frames = {}
+    for addr, length, frame in records:
+        per = frames.setdefault(frame, {})
+        end = addr + max(length, 1)
+        while addr < end:
+            name = layout.symbol_at(addr)
+            if name is None:
+                break
+            sym_end = layout.start[name] + layout.size[name]
+            chunk = min(end, sym_end) - addr
+            if chunk <= 0:
+                break
+            per.setdefault(name, []).append((addr - layout.start[name], chunk))
+            addr += chunk
+    return frames
+
+
+def cluster(hot, sizes, hotness, affinity, page):
+    """Greedy chaining: seed with the hottest image, then keep adding the
+    image most often drawn in the same frames while the run fits in a page.
+    Images bigger than a page form their own run."""
+    remaining = sorted(hot, key=lambda n: (-hotness[n], n))
+    runs = []
+    while remaining:
+        seed = remaining.pop(0)
+        run = [seed]
+        used = sizes[seed]
+        if used < page:
+            while True:
+                best, best_score = None, 0
+                for n in remaining:
+                    if used + sizes[n] > page:
+                        continue
+                    score = sum(affinity.get((min(n, m), max(n, m)), 0) for m in run)
+                    if score > best_score or (score == best_score and best is not None and hotness[n] > hotness[best]):
+                        best, best_score = n, score
+                if best is None or best_score == 0:
+                    break
+                remaining.remove(best)
+                run.append(best)
+                used += sizes[best]
+        runs.append(run)
+    return runs
+
+
+def pages_spanned(pos, size, page):
+    return (pos + max(size, 1) - 1) // page - pos // page + 1
+
+
+def needs_align(pos, size, page):
+    """Pad to the next page only when that makes the run span fewer pages."""
+    if pos % page == 0:
+        return False
+    aligned = pos + page - pos % page
+    return pages_spanned(aligned, size, page) < pages_spanned(pos, size, page)
+
+
+def new_offsets(layout, image_order, runs, cold, page):
+    """Estimate the repacked offsets: images are laid out run by run from where
+    images.txt starts (a run is padded to a page boundary when that saves a
+    page), everything after the image region shifts."""
+    first = min(layout.start[n] for n in image_order)
+    old_end = max(layout.start[n] + layout.size[n] for n in image_order)
+
+    placed = {}
+    aligned = set()
+    pos = first
+    for i, run in enumerate(runs):
+        size = sum(layout.size[n] for n in run)
+        if needs_align(pos, size, page):
+            pos += page - pos % page
+            aligned.add(i)
+        for n in run:
+            placed[n] = pos
+            pos += layout.size[n]
+    for n in cold:
+        placed[n] = pos
+        pos += layout.size[n]
+
+    delta = pos - old_end
+    moved = set(image_order)
+    for n, o in layout.start.items():
+        if n in moved:
+            continue
+        placed[n] = o + delta if o >= old_end else o
+    return placed, aligned, pos - first, old_end - first
+
+
+def pages_per_frame(frames, base_of, page):
+    counts = []
+    for per in frames.values():
+        pages = set()
+        for name, spans in per.items():
+            base = base_of[name]
+            for off, length in spans:
+                a = base + off
+                for p in range(a // page, (a + length - 1) // page + 1):
+                    pages.add(p)
+        counts.append(len(pages))
+    return counts
+
+
+def write_outputs(fxdir, images_txt, fxdata_txt, runs, aligned, cold, decl, page):
+    out_images = os.path.join(fxdir, 'images-repacked.txt')
+    with open(out_images, 'w') as f:
+        f.write('// Generated by scripts/fxrepack.py from {} - do not edit.\n\n'.format(os.path.basename(images_txt)))
+        f.write('namespace Images {\n\n')
+        for i, run in enumerate(runs):
+            if i in aligned:
+                f.write('    align {}\n'.format(page))
+            for n in run:
+                f.write('    {}\n'.format(decl[n]))
+            f.write('\n')
+        if cold:
+            f.write('    // Not seen in the trace ..\n\n')
+            for n in cold:
+                f.write('    {}\n'.format(decl[n]))
+        f.write('\n}\n\nnamespace_end\n')
+
+    with open(fxdata_txt) as f:
+        text = f.read()
+    name = os.path.basename(images_txt)
+    needle = 'include "{}"'.format(name)
+    if needle not in text:
+        sys.exit('{}: no {} line to replace'.format(fxdata_txt, needle))
+    out_fxdata = os.path.join(fxdir, 'fxdata-repacked.txt')
+    with open(out_fxdata, 'w') as f:
+        f.write(text.replace(needle, 'include "images-repacked.txt"'))
+    print('Wrote {} and {}'.format(out_fxdata, out_images))
+    return out_fxdata
+
+
+def main():
+    ap = argparse.ArgumentParser(description='Reorder fxdata images by co-access in an FX trace.')
+    ap.add_argument('trace', help='fxtrace.bin recorded with ARDULIB_FX_TRACE')
+    ap.add_argument('--dir', default='.', help='fxdata folder (default: current folder)')
+    ap.add_argument('--page', type=int, default=1024, help='cache page size to pack for (default 1024)')
+    ap.add_argument('--write', action='store_true', help='write fxdata-repacked.txt / images-repacked.txt')
+    ap.add_argument('--build', action='store_true', help='also run fxdata-build.py on the repacked script')
+    ap.add_argument('--install', action='store_true', help='also copy the result over fxdata.h and ../assets/POA/fxdata.bin')
+    args = ap.parse_args()
+
+    fxdir = os.path.abspath(args.dir)
+    header = os.path.join(fxdir, 'fxdata.h')
+    images_txt = os.path.join(fxdir, 'images.txt')
+    fxdata_txt = os.path.join(fxdir, 'fxdata.txt')
+
+    symbols, data_bytes = read_symbols(header)
+    layout = Layout(symbols, data_bytes)
+    image_order, decl = read_images(images_txt)
+    image_order = [n for n in image_order if n in layout.start]
+
+    records = read_trace(args.trace)
+    frames = frames_by_symbol(records, layout)
+    print('{} reads over {} frames, {} labels, {} images'.format(len(records), len(frames), len(symbols), len(image_order)))
+
+    images = set(image_order)
+    hotness = {n: 0 for n in image_order}
+    affinity = {}
+    for per in frames.values():
+        touched = sorted(n for n in per if n in images)
+        for n in touched:
+            hotness[n] += 1
+        for i in range(len(touched)):
+            for j in range(i + 1, len(touched)):
+                key = (touched[i], touched[j])
+                affinity[key] = affinity.get(key, 0) + 1
+
+    hot = [n for n in image_order if hotness[n] > 0]
+    cold = [n for n in image_order if hotness[n] == 0]
+    runs = cluster(hot, layout.size, hotness, affinity, args.page)
+
+    placed, aligned, new_size, old_size = new_offsets(layout, image_order, runs, cold, args.page)
+    before = pages_per_frame(frames, layout.start, args.page)
+    after = pages_per_frame(frames, placed, args.page)
+
+    def summary(c):
+        return 'mean {:.2f}  max {}'.format(sum(c) / len(c), max(c)) if c else 'n/a'
+
+    print('{} hot images in {} runs ({} page-aligned), {} cold'.format(len(hot), len(runs), len(aligned), len(cold)))
+    print('Image region {} -> {} bytes ({:+d} padding)'.format(old_size, new_size, new_size - old_size))
+    print('Distinct {}-byte pages per frame: current {}'.format(args.page, summary(before)))
+    print('                                  repacked {}'.format(summary(after)))
+
+    if not (args.write or args.build or args.install):
+        return
+
+    out_fxdata = write_outputs(fxdir, images_txt, fxdata_txt, runs, aligned, cold, decl, args.page)
+
+    if args.build or args.install:
+        tool = os.path.join(fxdir, 'Arduboy-Python-Utilities-master', 'fxdata-build.py')
+        subprocess.check_call([sys.executable, tool, os.path.basename(out_fxdata)], cwd=fxdir)
+
+    if args.install:
+        shutil.copyfile(os.path.join(fxdir, 'fxdata-repacked.h'), header)
+        shutil.copyfile(os.path.join(fxdir, 'fxdata-repacked.bin'), os.path.join(fxdir, 'fxdata.bin'))
+        assets = os.path.join(fxdir, '..', 'assets', 'POA', 'fxdata.bin')
+        if os.path.isdir(os.path.dirname(assets)):
+            shutil.copyfile(os.path.join(fxdir, 'fxdata-repacked.bin'), assets)
+        print('Installed repacked fxdata.h / fxdata.bin')
+
+
+if __name__ == '__main__':
+    main()
@@ -1,5 +1,6 @@
 #include "lib/ArduboyFX.h"
 #include "src/utils/Arduboy2Ext.h"
+#include "lib/include/FxBlit.h"
 
 static inline size_t fx_min_sz(size_t a, size_t b) {
     return a < b ? a : b;
@@ -7,6 +8,21 @@ static inline size_t fx_min_sz(size_t a, size_t b) {
 static inline uint16_t fx_be16(const uint8_t* p) {
     return ((uint16_t)p[0] << 8) | (uint16_t)p[1];
 }
+static uint32_t fx_crc32(uint32_t crc, const uint8_t* p, size_t len) {
+    crc = ~crc;
+    while(len--) {
+        crc ^= *p++;
+        for(uint8_t k = 0; k < 8; k++)
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+    }
+    return ~crc;
+}
+static_assert(FX::dbmMasked == FX_BLIT_MASKED && (1u << FX::dbfFlip) == FX_BLIT_FLIP &&
+                  (1u << FX::dbfWhiteBlack) == FX_BLIT_WHITE_BLACK &&
+                  (1u << FX::dbfInvert) == FX_BLIT_INVERT && (1u << FX::dbfBlack) == FX_BLIT_BLACK &&
+                  (1u << FX::dbfReverseBlack) == FX_BLIT_REVERSE_BLACK,
+              "FxBlit.h mode bits must match FX::DrawMode");
+
 uint16_t FX::programDataPage = 0;
 uint16_t FX::programSavePage = 0;
 
@@ -29,21 +45,71 @@ uint8_t FX::cache_pages_ = 30;
 uint8_t* FX::cache_mem_ = nullptr;
 uint32_t* FX::cache_base_ = nullptr;
 uint16_t* FX::cache_len_ = nullptr;
-uint32_t* FX::cache_age_ = nullptr;
 uint8_t* FX::cache_valid_ = nullptr;
-uint32_t FX::cache_age_ctr_ = 1;
-
-uint8_t FX::last_hit_ = 0xFF;
+uint8_t* FX::cache_prev_ = nullptr;
+uint8_t* FX::cache_next_ = nullptr;
+uint8_t FX::lru_head_ = FX::kNoSlot;
+uint8_t FX::lru_tail_ = FX::kNoSlot;
+uint8_t* FX::page_hash_ = nullptr;
+uint16_t FX::page_hash_mask_ = 0;
+
+uint8_t FX::last_hit_ = FX::kNoSlot;
 uint32_t FX::last_base_ = 0;
 uint8_t FX::seq_score_ = 0;
 
-uint8_t FX::stream_page_i_ = 0xFF;
+uint8_t FX::stream_page_i_ = FX::kNoSlot;
 uint32_t FX::stream_base_ = 0;
 uint16_t FX::stream_len_ = 0;
 uint32_t FX::stream_abs_ = 0;
 uint8_t* FX::stream_ptr_ = nullptr;
 bool FX::stream_valid_ = false;
 
+FX::PrefetchReq FX::prefetch_ring_[FX::kPrefetchRingSize];
+uint8_t FX::prefetch_head_ = 0;
+uint8_t FX::prefetch_tail_ = 0;
+uint8_t FX::prefetch_retire_ = 0;
+bool FX::prefetch_running_ = false;
+FuriThread* FX::prefetch_thread_ = nullptr;
+File* FX::prefetch_file_ = nullptr;
+
+uint8_t FX::save_mem_[FX::kSaveBlockSize];
+uint16_t FX::save_dirty_lo_ = 0;
+uint16_t FX::save_dirty_hi_ = 0;
+
+uint8_t* FX::save_stage_ = nullptr;
+uint8_t* FX::save_latest_ = nullptr;
+uint16_t FX::save_stage_size_ = 0;
+uint16_t FX::save_stage_len_[3] = {0, 0, 0};
+uint16_t FX::save_latest_len_ = 0;
+uint32_t FX::save_stage_seq_[3] = {0, 0, 0};
+uint8_t FX::save_front_ = 0;
+uint8_t FX::save_middle_ = 1;
+uint8_t FX::save_back_ = 2;
+uint32_t FX::save_seq_ = 0;
+uint8_t FX::save_disk_slot_ = 1;
+bool FX::save_running_ = false;
+FuriThread* FX::save_thread_ = nullptr;
+File* FX::save_slots_file_ = nullptr;
+
+uint16_t FX::pack_page_size_ = 0;
+uint32_t FX::pack_raw_size_ = 0;
+uint32_t FX::pack_pages_ = 0;
+uint32_t* FX::pack_index_ = nullptr;
+uint8_t* FX::pack_buf_ = nullptr;
+uint8_t* FX::prefetch_pack_buf_ = nullptr;
+
+#ifdef ARDULIB_FX_TRACE
+File* FX::trace_ = nullptr;
+uint8_t FX::trace_buf_[FX::kTraceBufRecords * FX_TRACE_RECORD_SIZE];
+uint16_t FX::trace_count_ = 0;
+uint16_t FX::trace_frame_ = 0;
+uint8_t FX::trace_tag_ = FxTraceTagNone;
+bool FX::trace_stream_open_ = false;
+uint32_t FX::trace_stream_start_ = 0;
+#endif
+
+uint32_t FX::cache_epoch_ = 1;
+
 bool FX::pending_valid_ = false;
 uint8_t FX::pending_byte_ = 0xFF;
 
@@ -52,6 +118,20 @@ uint24_t FX::frame_base_addr_ = 0;
 uint8_t FX::frame_count_ = 0;
 uint8_t FX::frame_idx_ = 0;
 
+uint8_t FX::draw_scratch_[FX::kDrawScratchSize];
+
+FX::BitmapMetaCacheEntry FX::bitmap_meta_cache_[FX::kBitmapMetaCacheSize];
+uint8_t FX::bitmap_meta_rr_ = 0;
+FX::BitmapMetaStats FX::bitmap_meta_stats_ = {0, 0};
+
+FX::DrawCommand FX::draw_list_[FX::kDrawListSize];
+uint8_t FX::draw_waits_[FX::kDrawListSize];
+uint8_t FX::draw_list_len_ = 0;
+uint8_t FX::draw_layer_ = 0;
+bool FX::draw_list_active_ = false;
+FX::DrawListStats FX::draw_list_stats_ = {0, 0, 0, 0, 0, 0, 0, 0};
+uint32_t FX::page_misses_ = 0;
+
 uint32_t FX::alignDown_(uint32_t v, uint32_t a) {
     return a ? (v & ~(a - 1u)) : v;
 }
@@ -62,9 +142,12 @@ uint32_t FX::alignUp_(uint32_t v, uint32_t a) {
 }
 
 void FX::setCacheConfig(uint32_t page_size, uint8_t pages) {
-    if(page_size < 512) page_size = 512;
-    page_size = alignUp_(page_size, 512);
+    // alignDown_() masks, so the page must be a power of two.
+    uint32_t p = 512;
+    while(p < page_size && p < 0x80000000u) p <<= 1;
+    page_size = p;
     if(pages < 2) pages = 2;
+    if(pages > kMaxCachePages) pages = kMaxCachePages;
     page_size_ = page_size;
     cache_pages_ = pages;
 }
@@ -97,10 +180,122 @@ bool FX::openData_() {
     if(data_opened_) return true;
     if(!data_) return false;
     if(!storage_file_open(data_, data_path_, FSAM_READ, FSOM_OPEN_EXISTING)) return false;
+    if(!packOpen_()) {
+        storage_file_close(data_);
+        return false;
+    }
     data_opened_ = true;
     return true;
 }
 
+// A data file that starts with FX_PACK_MAGIC is a paged container: load the
+// page index and size the decode buffers. Anything else is a plain fxdata.bin.
+bool FX::packOpen_() {
+    packClose_();
+
+    uint8_t hdr[FX_PACK_HEADER_SIZE];
+    if(storage_file_read(data_, hdr, sizeof(hdr)) != sizeof(hdr) ||
+       memcmp(hdr, FX_PACK_MAGIC, 4) != 0)
+        return true;
+
+    const uint16_t page = (uint16_t)(hdr[6] | (hdr[7] << 8));
+    const uint32_t raw_size = fx_pack_le32(hdr + 8);
+    const uint32_t pages = fx_pack_le32(hdr + 12);
+    // Cache pages must start on a container page, so the container page has
+    // to be a power of two that divides page_size_.
+    if(hdr[4] != FX_PACK_VERSION || hdr[5] != FX_PACK_CODEC_LZ4 || page < 256 ||
+       (page & (page - 1u)) || page_size_ % page || pages == 0 ||
+       pages != (raw_size + page - 1u) / page)
+        return false;
+
+    const size_t index_bytes = sizeof(uint32_t) * ((size_t)pages + 1u);
+    pack_index_ = (uint32_t*)malloc(index_bytes);
+    if(!pack_index_) return false;
+    if(storage_file_read(data_, pack_index_, index_bytes) != index_bytes) {
+        packClose_();
+        return false;
+    }
+
+    // The index is little-endian on disk, like the target. Validate it once
+    // so dataReadPage_() can trust the offsets.
+    const uint64_t file_size = storage_file_size(data_);
+    uint32_t max_packed = 0;
+    for(uint32_t i = 0; i < pages; i++) {
+        const uint32_t stored = pack_index_[i + 1] - pack_index_[i];
+        const uint32_t raw = (i + 1u == pages) ? raw_size - i * page : page;
+        if(pack_index_[i + 1] < pack_index_[i] || stored == 0 || stored > raw) {
+            packClose_();
+            return false;
+        }
+        if(stored < raw && stored > max_packed) max_packed = stored;
+    }
+    if(pack_index_[pages] > file_size) {
+        packClose_();
+        return false;
+    }
+
+    // Separate buffers for the game thread and the prefetch worker.
+    if(max_packed) {
+        pack_buf_ = (uint8_t*)malloc(max_packed);
+        prefetch_pack_buf_ = (uint8_t*)malloc(max_packed);
+        if(!pack_buf_ || !prefetch_pack_buf_) {
+            packClose_();
+            return false;
+        }
+    }
+
+    pack_page_size_ = page;
+    pack_raw_size_ = raw_size;
+    pack_pages_ = pages;
+    return true;
+}
+
+void FX::packClose_() {
+    if(pack_index_) {
+        free(pack_index_);
+        pack_index_ = nullptr;
+    }
+    if(pack_buf_) {
+        free(pack_buf_);
+        pack_buf_ = nullptr;
+    }
+    if(prefetch_pack_buf_) {
+        free(prefetch_pack_buf_);
+        prefetch_pack_buf_ = nullptr;
+    }
+    pack_page_size_ = 0;
+    pack_raw_size_ = 0;
+    pack_pages_ = 0;
+}
+
+// Fills one cache page starting at `base` and returns the number of bytes
+// produced. Packed pages are read into `scratch` and decoded straight into
+// `dst`; stored pages are read into `dst` directly.
+size_t FX::dataReadPage_(File* f, uint32_t base, uint8_t* dst, uint8_t* scratch) {
+    if(!pack_page_size_) {
+        if(!storage_file_seek(f, base, true)) return 0;
+        return storage_file_read(f, dst, page_size_);
+    }
+
+    size_t out = 0;
+    for(uint32_t i = base / pack_page_size_; out < page_size_ && i < pack_pages_; i++) {
+        const uint32_t off = pack_index_[i];
+        const uint32_t stored = pack_index_[i + 1] - off;
+        const uint32_t raw =
+            (i + 1u == pack_pages_) ? pack_raw_size_ - i * pack_page_size_ : pack_page_size_;
+
+        if(!storage_file_seek(f, off, true)) break;
+        if(stored == raw) {
+            if(storage_file_read(f, dst + out, raw) != raw) break;
+        } else {
+            if(storage_file_read(f, scratch, stored) != stored) break;
+            if(fx_pack_decode(scratch, stored, dst + out, raw) != raw) break;
+        }
+        out += raw;
+    }
+    return out;
+}
+
 bool FX::fileFill_(File* f, uint8_t value, size_t len) {
     if(!f) return false;
     if(!storage_file_seek(f, 0, true)) return false;
@@ -121,6 +316,12 @@ bool FX::fileReadAt_(File* f, uint32_t off, void* out, size_t len) {
     return storage_file_read(f, out, len) == len;
 }
 
+size_t FX::fileReadSomeAt_(File* f, uint32_t off, void* out, size_t len) {
+    if(!f) return 0;
+    if(!storage_file_seek(f, off, true)) return 0;
+    return storage_file_read(f, out, len);
+}
+
 bool FX::fileWriteAt_(File* f, uint32_t off, const void* in, size_t len) {
     if(!f) return false;
     if(!storage_file_seek(f, off, true)) return false;
@@ -152,10 +353,17 @@ bool FX::openSave_() {
         save_opened_ = true;
     }
 
+    const size_t r = fileReadSomeAt_(save_, 0, save_mem_, kSaveBlockSize);
+    if(r < kSaveBlockSize) memset(save_mem_ + r, 0xFF, kSaveBlockSize - r);
+    save_dirty_lo_ = 0;
+    save_dirty_hi_ = 0;
+
     return true;
 }
 
 void FX::freeCaches_() {
+    prefetchStop_();
+
     if(cache_mem_) {
         free(cache_mem_);
         cache_mem_ = nullptr;
@@ -168,20 +376,36 @@ void FX::freeCaches_() {
         free(cache_len_);
         cache_len_ = nullptr;
     }
-    if(cache_age_) {
-        free(cache_age_);
-        cache_age_ = nullptr;
-    }
     if(cache_valid_) {
         free(cache_valid_);
         cache_valid_ = nullptr;
     }
+    if(cache_prev_) {
+        free(cache_prev_);
+        cache_prev_ = nullptr;
+    }
+    if(cache_next_) {
+        free(cache_next_);
+        cache_next_ = nullptr;
+    }
+    if(page_hash_) {
+        free(page_hash_);
+        page_hash_ = nullptr;
+    }
+    page_hash_mask_ = 0;
+    lru_head_ = kNoSlot;
+    lru_tail_ = kNoSlot;
 
-    last_hit_ = 0xFF;
+    bitmapMetaReset_();
+    draw_list_len_ = 0;
+    draw_list_active_ = false;
+
+    last_hit_ = kNoSlot;
     last_base_ = 0;
     seq_score_ = 0;
 
     streamReset_();
+    cache_epoch_++;
     pending_valid_ = false;
     pending_byte_ = 0xFF;
 }
@@ -189,26 +413,44 @@ void FX::freeCaches_() {
 bool FX::allocCaches_() {
     freeCaches_();
 
+    // packOpen_() only accepts a container page that divides page_size_.
+    if(pack_page_size_ && page_size_ % pack_page_size_) return false;
+
     cache_mem_ = (uint8_t*)malloc((size_t)page_size_ * (size_t)cache_pages_);
     cache_base_ = (uint32_t*)malloc(sizeof(uint32_t) * cache_pages_);
     cache_len_ = (uint16_t*)malloc(sizeof(uint16_t) * cache_pages_);
-    cache_age_ = (uint32_t*)malloc(sizeof(uint32_t) * cache_pages_);
     cache_valid_ = (uint8_t*)malloc(sizeof(uint8_t) * cache_pages_);
-
-    if(!cache_mem_ || !cache_base_ || !cache_len_ || !cache_age_ || !cache_valid_) {
+    cache_prev_ = (uint8_t*)malloc(sizeof(uint8_t) * cache_pages_);
+    cache_next_ = (uint8_t*)malloc(sizeof(uint8_t) * cache_pages_);
+
+    // Open-addressing table sized to keep the load factor at or below 1/2.
+    uint16_t hash_size = 4;
+    while(hash_size < (uint16_t)cache_pages_ * 2u)
+        hash_size <<= 1;
+    page_hash_ = (uint8_t*)malloc(hash_size);
+    page_hash_mask_ = (uint16_t)(hash_size - 1u);
+
+    if(!cache_mem_ || !cache_base_ || !cache_len_ || !cache_valid_ || !cache_prev_ ||
+       !cache_next_ || !page_hash_) {
         freeCaches_();
         return false;
     }
 
+    memset(page_hash_, kNoSlot, hash_size);
+
+    // All slots start on the LRU list, empty ones at the tail, so the victim
+    // is always lru_tail_ and empty slots are consumed before any eviction.
     for(uint8_t i = 0; i < cache_pages_; i++) {
         cache_valid_[i] = 0;
         cache_base_[i] = 0;
         cache_len_[i] = 0;
-        cache_age_[i] = 0;
+        cache_prev_[i] = (i == 0) ? kNoSlot : (uint8_t)(i - 1u);
+        cache_next_[i] = (i + 1u == cache_pages_) ? kNoSlot : (uint8_t)(i + 1u);
     }
+    lru_head_ = 0;
+    lru_tail_ = (uint8_t)(cache_pages_ - 1u);
 
-    cache_age_ctr_ = 1;
-    last_hit_ = 0xFF;
+    last_hit_ = kNoSlot;
     last_base_ = 0;
     seq_score_ = 0;
 
@@ -225,7 +467,79 @@ uint32_t FX::absDataOffset_(uint32_t address) {
     return address;
 }
 
+#ifdef ARDULIB_FX_TRACE
+void FX::traceOpen_() {
+    if(trace_ || !storage_) return;
+    trace_ = storage_file_alloc(storage_);
+    if(!trace_) return;
+    if(!storage_file_open(trace_, kTracePath, FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+        storage_file_free(trace_);
+        trace_ = nullptr;
+        return;
+    }
+
+    uint8_t hdr[FX_TRACE_HEADER_SIZE];
+    memcpy(hdr, FX_TRACE_MAGIC, 4);
+    hdr[4] = FX_TRACE_VERSION;
+    hdr[5] = FX_TRACE_RECORD_SIZE;
+    hdr[6] = (uint8_t)(page_size_ & 0xFFu);
+    hdr[7] = (uint8_t)(page_size_ >> 8);
+    storage_file_write(trace_, hdr, sizeof(hdr));
+
+    trace_count_ = 0;
+    trace_frame_ = 0;
+    trace_stream_open_ = false;
+}
+
+void FX::traceClose_() {
+    if(!trace_) return;
+    traceStreamEnd_();
+    traceFlush_();
+    storage_file_close(trace_);
+    storage_file_free(trace_);
+    trace_ = nullptr;
+}
+
+void FX::traceFlush_() {
+    if(!trace_ || trace_count_ == 0) return;
+    storage_file_write(trace_, trace_buf_, (size_t)trace_count_ * FX_TRACE_RECORD_SIZE);
+    trace_count_ = 0;
+}
+
+void FX::traceRecord_(uint32_t abs, uint32_t length, uint8_t kind) {
+    if(!trace_ || length == 0) return;
+    if(length > 0xFFFFu) length = 0xFFFFu;
+
+    uint8_t* r = trace_buf_ + (size_t)trace_count_ * FX_TRACE_RECORD_SIZE;
+    r[0] = (uint8_t)abs;
+    r[1] = (uint8_t)(abs >> 8);
+    r[2] = (uint8_t)(abs >> 16);
+    r[3] = (uint8_t)length;
+    r[4] = (uint8_t)(length >> 8);
+    r[5] = (uint8_t)trace_frame_;
+    r[6] = (uint8_t)(trace_frame_ >> 8);
+    r[7] = kind;
+    r[8] = trace_tag_;
+
+    if(++trace_count_ == kTraceBufRecords) traceFlush_();
+}
+
+// A data stream is logged once it ends, with the number of bytes it covered
+// (including the pending byte fetched ahead).
+void FX::traceStreamEnd_() {
+    if(!trace_stream_open_) return;
+    trace_stream_open_ = false;
+    traceRecord_(trace_stream_start_, cur_abs_ - trace_stream_start_, FxTraceKindStream);
+}
+#endif
+
 void FX::commit() {
+    if(save_dirty_hi_ <= save_dirty_lo_) return;
+    if(!save_opened_ || !save_) return;
+    if(!fileWriteAt_(save_, save_dirty_lo_, save_mem_ + save_dirty_lo_, save_dirty_hi_ - save_dirty_lo_))
+        return;
+    save_dirty_lo_ = 0;
+    save_dirty_hi_ = 0;
 }
 
 bool FX::begin() {
@@ -233,6 +547,7 @@ bool FX::begin() {
     if(!openData_()) return false;
     if(!openSave_()) return false;
     if(!allocCaches_()) return false;
+    saveWriterStart_();
 
     domain_ = Domain::Data;
     cur_abs_ = 0;
@@ -241,6 +556,11 @@ bool FX::begin() {
     pending_valid_ = false;
     pending_byte_ = 0xFF;
 
+    prefetchStart_();
+#ifdef ARDULIB_FX_TRACE
+    traceOpen_();
+#endif
+
     return true;
 }
 
@@ -256,11 +576,18 @@ bool FX::begin(uint16_t developmentDataPage, uint16_t developmentSavePage) {
 }
 
 void FX::end() {
+    prefetchStop_();
+#ifdef ARDULIB_FX_TRACE
+    traceClose_();
+#endif
+
     if(data_) {
         storage_file_close(data_);
         storage_file_free(data_);
         data_ = nullptr;
     }
+    saveWriterStop_();
+    commit();
     if(save_) {
         storage_file_close(save_);
         storage_file_free(save_);
@@ -268,6 +595,7 @@ void FX::end() {
     }
     data_opened_ = false;
     save_opened_ = false;
+    packClose_();
 
     if(storage_) {
         furi_record_close(RECORD_STORAGE);
@@ -293,7 +621,7 @@ void FX::readJedecID(JedecID* id) {
 }
 
 void FX::streamReset_() {
-    stream_page_i_ = 0xFF;
+    stream_page_i_ = kNoSlot;
     stream_base_ = 0;
     stream_len_ = 0;
     stream_abs_ = 0;
@@ -301,45 +629,134 @@ void FX::streamReset_() {
     stream_valid_ = false;
 }
 
-bool FX::dataPageHas_(uint32_t base) {
-    if(last_hit_ != 0xFF && cache_valid_[last_hit_] && cache_base_[last_hit_] == base) return true;
-    for(uint8_t i = 0; i < cache_pages_; i++) {
-        if(cache_valid_[i] && cache_base_[i] == base) {
-            last_hit_ = i;
-            return true;
-        }
+uint16_t FX::pageHashHome_(uint32_t base) {
+    // Bases are at least 512-byte aligned; Fibonacci-hash the page number.
+    return (uint16_t)(((base >> 9) * 2654435761u) >> 16) & page_hash_mask_;
+}
+
+uint8_t FX::pageHashFind_(uint32_t base) {
+    uint16_t h = pageHashHome_(base);
+    for(;;) {
+        const uint8_t slot = page_hash_[h];
+        if(slot == kNoSlot) return kNoSlot;
+        if(cache_base_[slot] == base) return slot;
+        h = (uint16_t)((h + 1u) & page_hash_mask_);
     }
-    return false;
 }
 
-uint8_t FX::dataPickVictim_() {
-    uint8_t victim = 0;
-    uint32_t best_age = 0xFFFFFFFFu;
-    for(uint8_t i = 0; i < cache_pages_; i++) {
-        if(!cache_valid_[i]) return i;
-        uint32_t a = cache_age_[i];
-        if(a < best_age) {
-            best_age = a;
-            victim = i;
+void FX::pageHashInsert_(uint32_t base, uint8_t slot) {
+    uint16_t h = pageHashHome_(base);
+    while(page_hash_[h] != kNoSlot)
+        h = (uint16_t)((h + 1u) & page_hash_mask_);
+    page_hash_[h] = slot;
+}
+
+void FX::pageHashErase_(uint32_t base) {
+    uint16_t h = pageHashHome_(base);
+    for(;;) {
+        const uint8_t slot = page_hash_[h];
+        if(slot == kNoSlot) return;
+        if(cache_base_[slot] == base) break;
+        h = (uint16_t)((h + 1u) & page_hash_mask_);
+    }
+
+    // Backward-shift deletion keeps probe chains intact without tombstones.
+    uint16_t hole = h;
+    uint16_t j = h;
+    for(;;) {
+        j = (uint16_t)((j + 1u) & page_hash_mask_);
+        const uint8_t slot = page_hash_[j];
+        if(slot == kNoSlot) break;
+        const uint16_t home = pageHashHome_(cache_base_[slot]);
+        if((uint16_t)((j - home) & page_hash_mask_) >= (uint16_t)((j - hole) & page_hash_mask_)) {
+            page_hash_[hole] = slot;
+            hole = j;
         }
     }
-    return victim;
+    page_hash_[hole] = kNoSlot;
+}
+
+void FX::lruUnlink_(uint8_t i) {
+    const uint8_t p = cache_prev_[i];
+    const uint8_t n = cache_next_[i];
+    if(p != kNoSlot)
+        cache_next_[p] = n;
+    else
+        lru_head_ = n;
+    if(n != kNoSlot)
+        cache_prev_[n] = p;
+    else
+        lru_tail_ = p;
+}
+
+void FX::lruPushFront_(uint8_t i) {
+    cache_prev_[i] = kNoSlot;
+    cache_next_[i] = lru_head_;
+    if(lru_head_ != kNoSlot)
+        cache_prev_[lru_head_] = i;
+    else
+        lru_tail_ = i;
+    lru_head_ = i;
+}
+
+void FX::lruPushBack_(uint8_t i) {
+    cache_next_[i] = kNoSlot;
+    cache_prev_[i] = lru_tail_;
+    if(lru_tail_ != kNoSlot)
+        cache_next_[lru_tail_] = i;
+    else
+        lru_head_ = i;
+    lru_tail_ = i;
+}
+
+void FX::lruTouch_(uint8_t i) {
+    if(lru_head_ == i) return;
+    lruUnlink_(i);
+    lruPushFront_(i);
+}
+
+void FX::lruDemote_(uint8_t i) {
+    if(lru_tail_ == i) return;
+    lruUnlink_(i);
+    lruPushBack_(i);
+}
+
+bool FX::dataPageHas_(uint32_t base) {
+    if(last_hit_ != kNoSlot && cache_valid_[last_hit_] && cache_base_[last_hit_] == base) return true;
+    const uint8_t i = pageHashFind_(base);
+    if(i == kNoSlot) return false;
+    last_hit_ = i;
+    return true;
+}
+
+uint8_t FX::dataPickVictim_() {
+    return lru_tail_;
 }
 
 bool FX::dataLoadPage_(uint32_t base, uint8_t page_i) {
     if(!data_opened_ && !openData_()) return false;
     if(!data_) return false;
 
-    if(!storage_file_seek(data_, base, true)) return false;
+    if(cache_valid_[page_i]) {
+        pageHashErase_(cache_base_[page_i]);
+        cache_valid_[page_i] = 0;
+    }
+    if(stream_page_i_ == page_i) streamReset_();
+    if(last_hit_ == page_i) last_hit_ = kNoSlot;
+    cache_epoch_++;
 
     uint8_t* dst = cache_mem_ + ((size_t)page_i * (size_t)page_size_);
-    size_t r = storage_file_read(data_, dst, page_size_);
-    if(r == 0) return false;
+    const size_t r = dataReadPage_(data_, base, dst, pack_buf_);
+    if(r == 0) {
+        lruDemote_(page_i);
+        return false;
+    }
 
     cache_valid_[page_i] = 1;
     cache_base_[page_i] = base;
     cache_len_[page_i] = (uint16_t)r;
-    cache_age_[page_i] = cache_age_ctr_++;
+    pageHashInsert_(base, page_i);
+    lruTouch_(page_i);
     last_hit_ = page_i;
 
     return true;
@@ -351,47 +768,188 @@ void FX::dataMaybePrefetch_(uint32_t base) {
 
     uint32_t next1 = base + page_size_;
     if(!dataPageHas_(next1)) {
+        if(prefetch_running_) {
+            (void)prefetchRequest_(next1);
+            return;
+        }
         uint8_t v = dataPickVictim_();
         if(!(cache_valid_[v] && cache_base_[v] == base)) (void)dataLoadPage_(next1, v);
     }
 }
 
-bool FX::dataEnsurePageIndex_(uint32_t abs_off, uint8_t* out_index) {
-    if(!cache_mem_ || !out_index) return false;
+// Background prefetch.
+//
+// prefetch_ring_ is a single-producer/single-consumer ring. The game thread
+// reserves a victim slot, takes it off the LRU list and the hash (so nothing
+// on the game side can read it), fills a request and publishes prefetch_head_.
+// The worker reads the page into the reserved slot with its own file handle
+// and publishes prefetch_tail_. The game thread then retires finished entries
+// in order from prefetchCollect_(), linking the slot back in as a valid page.
+// Nothing on the game side ever waits for the worker: a page that is still in
+// flight when it is needed is simply loaded synchronously, and the late copy
+// is discarded on retire.
+
+bool FX::prefetchStart_() {
+    if(prefetch_running_) return true;
+    if(!storage_ || !cache_mem_) return false;
+
+    prefetch_file_ = storage_file_alloc(storage_);
+    if(!prefetch_file_) return false;
+    if(!storage_file_open(prefetch_file_, data_path_, FSAM_READ, FSOM_OPEN_EXISTING)) {
+        storage_file_free(prefetch_file_);
+        prefetch_file_ = nullptr;
+        return false;
+    }
 
-    uint32_t base = alignDown_(abs_off, page_size_);
+    prefetch_head_ = 0;
+    prefetch_tail_ = 0;
+    prefetch_retire_ = 0;
+    __atomic_store_n(&prefetch_running_, true, __ATOMIC_RELEASE);
 
-    if(last_hit_ != 0xFF && cache_valid_[last_hit_] && cache_base_[last_hit_] == base) {
-        cache_age_[last_hit_] = cache_age_ctr_++;
-        *out_index = last_hit_;
-        if(base == last_base_ + page_size_) {
-            if(seq_score_ < 255) seq_score_++;
-        } else
-            seq_score_ = 0;
-        last_base_ = base;
-        dataMaybePrefetch_(base);
-        return true;
+#ifndef ARDULIB_FX_PREFETCH_MANUAL
+    prefetch_thread_ = furi_thread_alloc();
+    if(!prefetch_thread_) {
+        prefetchStop_();
+        return false;
     }
+    furi_thread_set_name(prefetch_thread_, "ArdulibFxPrefetch");
+    furi_thread_set_stack_size(prefetch_thread_, 1024);
+    furi_thread_set_priority(prefetch_thread_, FuriThreadPriorityLow);
+    furi_thread_set_callback(prefetch_thread_, prefetchThread_);
+    furi_thread_start(prefetch_thread_);
+#endif
 
-    for(uint8_t i = 0; i < cache_pages_; i++) {
-        if(cache_valid_[i] && cache_base_[i] == base) {
-            cache_age_[i] = cache_age_ctr_++;
-            last_hit_ = i;
-            *out_index = i;
-            if(base == last_base_ + page_size_) {
-                if(seq_score_ < 255) seq_score_++;
-            } else
-                seq_score_ = 0;
-            last_base_ = base;
-            dataMaybePrefetch_(base);
-            return true;
+    return true;
+}
+
+void FX::prefetchStop_() {
+    if(!prefetch_running_ && !prefetch_file_) return;
+
+    __atomic_store_n(&prefetch_running_, false, __ATOMIC_RELEASE);
+    if(prefetch_thread_) {
+        furi_thread_flags_set(furi_thread_get_id(prefetch_thread_), kPrefetchWakeFlag);
+        furi_thread_join(prefetch_thread_);
+        furi_thread_free(prefetch_thread_);
+        prefetch_thread_ = nullptr;
+    }
+
+    // Hand any reserved slots back as empty so the LRU list stays complete.
+    if(cache_mem_) {
+        while(prefetch_retire_ != prefetch_head_) {
+            const PrefetchReq& req = prefetch_ring_[prefetch_retire_ & (kPrefetchRingSize - 1u)];
+            cache_valid_[req.slot] = 0;
+            lruPushBack_(req.slot);
+            prefetch_retire_++;
         }
     }
+    prefetch_head_ = 0;
+    prefetch_tail_ = 0;
+    prefetch_retire_ = 0;
+
+    if(prefetch_file_) {
+        storage_file_close(prefetch_file_);
+        storage_file_free(prefetch_file_);
+        prefetch_file_ = nullptr;
+    }
+}
+
+bool FX::prefetchRequest_(uint32_t base) {
+    const uint8_t inflight = (uint8_t)(prefetch_head_ - prefetch_retire_);
+    if(inflight >= kPrefetchRingSize) return false;
+    // Always leave at least two slots on the LRU list for synchronous loads.
+    if((uint8_t)(inflight + 2u) >= cache_pages_) return false;
 
-    uint8_t victim = dataPickVictim_();
-    if(!dataLoadPage_(base, victim)) return false;
+    for(uint8_t n = prefetch_retire_; n != prefetch_head_; n++) {
+        if(prefetch_ring_[n & (kPrefetchRingSize - 1u)].base == base) return true;
+    }
+
+    const uint8_t v = dataPickVictim_();
+    if(cache_valid_[v]) {
+        pageHashErase_(cache_base_[v]);
+        cache_valid_[v] = 0;
+    }
+    if(stream_page_i_ == v) streamReset_();
+    if(last_hit_ == v) last_hit_ = kNoSlot;
+    cache_epoch_++;
+    lruUnlink_(v);
+    cache_base_[v] = base;
+    cache_len_[v] = 0;
+
+    PrefetchReq& req = prefetch_ring_[prefetch_head_ & (kPrefetchRingSize - 1u)];
+    req.base = base;
+    req.slot = v;
+    __atomic_store_n(&prefetch_head_, (uint8_t)(prefetch_head_ + 1u), __ATOMIC_RELEASE);
+
+    if(prefetch_thread_) furi_thread_flags_set(furi_thread_get_id(prefetch_thread_), kPrefetchWakeFlag);
+    return true;
+}
 
-    *out_index = victim;
+void FX::prefetchCollect_() {
+    const uint8_t done = __atomic_load_n(&prefetch_tail_, __ATOMIC_ACQUIRE);
+    while(prefetch_retire_ != done) {
+        const PrefetchReq& req = prefetch_ring_[prefetch_retire_ & (kPrefetchRingSize - 1u)];
+        const uint8_t s = req.slot;
+        if(cache_len_[s] != 0 && pageHashFind_(req.base) == kNoSlot) {
+            cache_valid_[s] = 1;
+            pageHashInsert_(req.base, s);
+            lruPushFront_(s);
+        } else {
+            cache_valid_[s] = 0;
+            lruPushBack_(s);
+        }
+        prefetch_retire_++;
+    }
+}
+
+bool FX::prefetchServiceOne_() {
+    const uint8_t tail = prefetch_tail_;
+    if(tail == __atomic_load_n(&prefetch_head_, __ATOMIC_ACQUIRE)) return false;
+
+    const PrefetchReq& req = prefetch_ring_[tail & (kPrefetchRingSize - 1u)];
+    uint8_t* dst = cache_mem_ + ((size_t)req.slot * (size_t)page_size_);
+    const size_t r = dataReadPage_(prefetch_file_, req.base, dst, prefetch_pack_buf_);
+    cache_len_[req.slot] = (uint16_t)r;
+
+    __atomic_store_n(&prefetch_tail_, (uint8_t)(tail + 1u), __ATOMIC_RELEASE);
+    return true;
+}
+
+int32_t FX::prefetchThread_(void* context) {
+    UNUSED(context);
+    while(__atomic_load_n(&prefetch_running_, __ATOMIC_ACQUIRE)) {
+        if(!prefetchServiceOne_())
+            furi_thread_flags_wait(kPrefetchWakeFlag, FuriFlagWaitAny, FuriWaitForever);
+    }
+    return 0;
+}
+
+#ifdef ARDULIB_FX_PREFETCH_MANUAL
+bool FX::prefetchStep() {
+    if(!prefetch_running_) return false;
+    return prefetchServiceOne_();
+}
+#endif
+
+bool FX::dataEnsurePageIndex_(uint32_t abs_off, uint8_t* out_index) {
+    if(!cache_mem_ || !out_index) return false;
+
+    if(prefetch_retire_ != prefetch_head_) prefetchCollect_();
+
+    uint32_t base = alignDown_(abs_off, page_size_);
+
+    uint8_t i = last_hit_;
+    if(i == kNoSlot || !cache_valid_[i] || cache_base_[i] != base) i = pageHashFind_(base);
+
+    if(i != kNoSlot) {
+        lruTouch_(i);
+        last_hit_ = i;
+    } else {
+        page_misses_++;
+        i = dataPickVictim_();
+        if(!dataLoadPage_(base, i)) return false;
+    }
+
+    *out_index = i;
 
     if(base == last_base_ + page_size_) {
         if(seq_score_ < 255) seq_score_++;
@@ -465,17 +1023,21 @@ void FX::primePendingData_() {
 
 void FX::primePendingSave_() {
     pending_valid_ = false;
-    uint8_t v = 0xFF;
-    if(save_opened_ && save_ && cur_abs_ < (uint32_t)kSaveBlockSize)
-        (void)fileReadAt_(save_, cur_abs_, &v, 1);
-    pending_byte_ = v;
+    pending_byte_ = saveByteAt_(cur_abs_);
     pending_valid_ = true;
     cur_abs_++;
 }
 
 void FX::seekData(uint32_t address) {
+#ifdef ARDULIB_FX_TRACE
+    traceStreamEnd_();
+#endif
     domain_ = Domain::Data;
     cur_abs_ = absDataOffset_(address);
+#ifdef ARDULIB_FX_TRACE
+    trace_stream_open_ = true;
+    trace_stream_start_ = cur_abs_;
+#endif
     primePendingData_();
 }
 
@@ -487,6 +1049,9 @@ void FX::seekDataArray(uint32_t address, uint8_t index, uint8_t offset, uint8_t
 }
 
 void FX::seekSave(uint32_t address) {
+#ifdef ARDULIB_FX_TRACE
+    traceStreamEnd_();
+#endif
     domain_ = Domain::Save;
     cur_abs_ = address;
     primePendingSave_();
@@ -503,10 +1068,7 @@ uint8_t FX::readPendingUInt8() {
     uint8_t out = pending_byte_;
 
     if(domain_ == Domain::Save) {
-        uint8_t v = 0xFF;
-        if(save_opened_ && save_ && cur_abs_ < (uint32_t)kSaveBlockSize)
-            (void)fileReadAt_(save_, cur_abs_, &v, 1);
-        pending_byte_ = v;
+        pending_byte_ = saveByteAt_(cur_abs_);
         pending_valid_ = true;
         cur_abs_++;
         return out;
@@ -526,6 +1088,9 @@ uint8_t FX::readPendingUInt8() {
 }
 
 uint8_t FX::readEnd() {
+#ifdef ARDULIB_FX_TRACE
+    if(domain_ == Domain::Data) traceStreamEnd_();
+#endif
     if(!pending_valid_) return 0xFF;
     uint8_t out = pending_byte_;
     pending_valid_ = false;
@@ -642,19 +1207,36 @@ uint32_t FX::readIndexedUInt32(uint32_t address, uint8_t index) {
     return readPendingLastUInt32();
 }
 
+uint8_t FX::saveByteAt_(uint32_t off) {
+    if(!save_opened_ || off >= (uint32_t)kSaveBlockSize) return 0xFF;
+    return save_mem_[off];
+}
+
+void FX::saveMarkDirty_(uint32_t off, size_t len) {
+    if(len == 0) return;
+    const uint16_t lo = (uint16_t)off;
+    const uint16_t hi = (uint16_t)(off + len);
+    if(save_dirty_hi_ <= save_dirty_lo_) {
+        save_dirty_lo_ = lo;
+        save_dirty_hi_ = hi;
+        return;
+    }
+    if(lo < save_dirty_lo_) save_dirty_lo_ = lo;
+    if(hi > save_dirty_hi_) save_dirty_hi_ = hi;
+}
+
 uint16_t FX::readSaveU16BE_(uint16_t off) {
     if(!save_opened_ || !save_) return 0xFFFF;
     if((uint32_t)off + 1u >= (uint32_t)kSaveBlockSize) return 0xFFFF;
-    uint8_t b[2] = {0xFF, 0xFF};
-    if(!fileReadAt_(save_, off, b, 2)) return 0xFFFF;
-    return ((uint16_t)b[0] << 8) | b[1];
+    return ((uint16_t)save_mem_[off] << 8) | save_mem_[off + 1u];
 }
 
 void FX::writeSaveU16BE_(uint16_t off, uint16_t v) {
     if(!save_opened_ || !save_) return;
     if((uint32_t)off + 1u >= (uint32_t)kSaveBlockSize) return;
-    uint8_t b[2] = {(uint8_t)(v >> 8), (uint8_t)(v & 0xFF)};
-    (void)fileWriteAt_(save_, off, b, 2);
+    save_mem_[off] = (uint8_t)(v >> 8);
+    save_mem_[off + 1u] = (uint8_t)(v & 0xFF);
+    saveMarkDirty_(off, 2);
 }
 
 bool FX::readDataAt_(uint32_t address, uint8_t* buffer, size_t length) {
@@ -662,6 +1244,9 @@ bool FX::readDataAt_(uint32_t address, uint8_t* buffer, size_t length) {
 
     uint32_t abs = absDataOffset_(address);
     size_t done = 0;
+#ifdef ARDULIB_FX_TRACE
+    traceRecord_(abs, (uint32_t)length, FxTraceKindRead);
+#endif
 
     while(done < length) {
         uint8_t page_i = 0xFF;
@@ -691,6 +1276,9 @@ const uint8_t* FX::dataPtrAt_(uint32_t address, size_t length) {
     if(length == 0) return nullptr;
 
     const uint32_t abs = absDataOffset_(address);
+#ifdef ARDULIB_FX_TRACE
+    traceRecord_(abs, (uint32_t)length, FxTraceKindPtr);
+#endif
     uint8_t page_i = 0xFF;
     if(!dataEnsurePageIndex_(abs, &page_i)) return nullptr;
 
@@ -705,14 +1293,99 @@ const uint8_t* FX::dataPtrAt_(uint32_t address, size_t length) {
     return cache_mem_ + ((size_t)page_i * (size_t)page_size_) + (size_t)off;
 }
 
+void FX::Reader::seek(uint24_t address) {
+    ptr_ = nullptr;
+    end_ = nullptr;
+    end_abs_ = absDataOffset_(address);
+}
+
+void FX::Reader::seekArray(uint24_t address, uint8_t index, uint8_t offset, uint8_t elementSize) {
+    uint32_t add = (elementSize == 0) ? (uint32_t)index * 256u : (uint32_t)index * (uint32_t)elementSize;
+    seek(address + add + offset);
+}
+
+void FX::Reader::skip(uint32_t length) {
+    if(epoch_ == cache_epoch_ && (uint32_t)(end_ - ptr_) > length) {
+        ptr_ += length;
+        return;
+    }
+    end_abs_ = position_() + length;
+    ptr_ = nullptr;
+    end_ = nullptr;
+}
+
+// Points the cursor at the rest of the page holding the current position.
+bool FX::Reader::refill_() {
+    const uint32_t abs = position_();
+    ptr_ = nullptr;
+    end_ = nullptr;
+    end_abs_ = abs;
+
+    uint8_t page_i = kNoSlot;
+    if(!dataEnsurePageIndex_(abs, &page_i)) return false;
+
+    const uint32_t base = cache_base_[page_i];
+    const uint16_t len = cache_len_[page_i];
+    if(abs < base || abs - base >= len) return false;
+
+    const uint8_t* page = cache_mem_ + ((size_t)page_i * (size_t)page_size_);
+    ptr_ = page + (abs - base);
+    end_ = page + len;
+    end_abs_ = base + len;
+    epoch_ = cache_epoch_;
+#ifdef ARDULIB_FX_TRACE
+    traceRecord_(abs, (uint32_t)(end_ - ptr_), FxTraceKindSpan);
+#endif
+    return true;
+}
+
+uint8_t FX::Reader::refillUInt8_() {
+    if(!refill_()) {
+        end_abs_++;
+        return 0xFF;
+    }
+    return *ptr_++;
+}
+
+void FX::Reader::readBytes(uint8_t* buffer, size_t length) {
+    while(length) {
+        size_t chunk = length;
+        const uint8_t* src = span(chunk);
+        if(!src) {
+            memset(buffer, 0xFF, length);
+            end_abs_ += (uint32_t)length;
+            return;
+        }
+        memcpy(buffer, src, chunk);
+        buffer += chunk;
+        length -= chunk;
+    }
+}
+
+const uint8_t* FX::Reader::span(size_t& length) {
+    if((ptr_ == end_ || epoch_ != cache_epoch_) && !refill_()) {
+        length = 0;
+        return nullptr;
+    }
+    const size_t available = (size_t)(end_ - ptr_);
+    if(length > available) length = available;
+    const uint8_t* out = ptr_;
+    ptr_ += length;
+    return out;
+}
+
 void FX::eraseSaveBlock(uint16_t) {
     if(!save_opened_ || !save_) return;
-    (void)storage_file_seek(save_, 0, true);
-    (void)fileFill_(save_, 0xFF, kSaveBlockSize);
+    memset(save_mem_, 0xFF, kSaveBlockSize);
+    saveMarkDirty_(0, kSaveBlockSize);
 }
 
 uint8_t FX::loadGameState(uint8_t* gameState, size_t size) {
     if(!gameState || size == 0) return 0;
+    if(save_latest_ && save_latest_len_ == size) {
+        memcpy(gameState, save_latest_, size);
+        return 1;
+    }
     if(!save_opened_ || !save_) return 0;
     if(size > 4094u) return 0;
 
@@ -728,13 +1401,28 @@ uint8_t FX::loadGameState(uint8_t* gameState, size_t size) {
         const uint32_t next = payload_off + (uint32_t)size;
         if(next > (uint32_t)kSaveBlockSize) break;
 
-        if(!fileReadAt_(save_, payload_off, gameState, size)) break;
+        memcpy(gameState, save_mem_ + payload_off, size);
         loaded = 1;
         addr = (uint16_t)next;
     }
     return loaded;
 }
 
+size_t FX::loadGameStateUpTo(uint8_t* gameState, size_t capacity) {
+    if(!gameState || capacity == 0) return 0;
+    if(save_latest_ && save_latest_len_) {
+        if(save_latest_len_ > capacity) return 0;
+        memcpy(gameState, save_latest_, save_latest_len_);
+        return save_latest_len_;
+    }
+    if(!save_opened_ || !save_) return 0;
+
+    // The log only chains records of one size, so the first header decides.
+    const uint16_t size = readSaveU16BE_(0);
+    if(size == 0 || size > capacity || size > 4094u) return 0;
+    return loadGameState(gameState, size) ? size : 0;
+}
+
 void FX::saveGameState(const uint8_t* gameState, size_t size) {
     if(!gameState || size == 0) return;
     if(!save_opened_ || !save_) return;
@@ -759,7 +1447,192 @@ void FX::saveGameState(const uint8_t* gameState, size_t size) {
 
     // Write record in original order: size header, then payload.
     writeSaveU16BE_(addr, (uint16_t)size);
-    (void)fileWriteAt_(save_, (uint32_t)addr + 2u, gameState, size);
+    memcpy(save_mem_ + addr + 2u, gameState, size);
+    saveMarkDirty_((uint32_t)addr + 2u, size);
+}
+
+// Async saves: fxslots.bin holds two slots of kSaveSlotSize bytes,
+//   "FXSV" seq:u32 size:u16 reserved:u16 crc32:u32 payload[size]
+// with the CRC over the first 12 header bytes and the payload. The writer
+// always overwrites the slot that does not hold the newest save, so a torn
+// write leaves the previous one intact; the scan at begin() keeps the valid
+// slot with the highest sequence number. Saves handed in faster than they
+// are written collapse to the latest one.
+
+bool FX::saveGameStateAsync(const uint8_t* gameState, size_t size) {
+    if(!gameState || size == 0) return false;
+    if(!save_running_ || !save_stage_ || size > (size_t)save_stage_size_) {
+        saveGameState(gameState, size);
+        commit();
+        return false;
+    }
+
+    memcpy(save_latest_, gameState, size);
+    save_latest_len_ = (uint16_t)size;
+    memcpy(save_stage_ + (size_t)save_front_ * save_stage_size_, gameState, size);
+    save_stage_len_[save_front_] = (uint16_t)size;
+    save_stage_seq_[save_front_] = ++save_seq_;
+    save_front_ = (uint8_t)(__atomic_exchange_n(&save_middle_, (uint8_t)(save_front_ | kSaveStageNew),
+                                                __ATOMIC_ACQ_REL) &
+                            ~kSaveStageNew);
+    furi_thread_flags_set(furi_thread_get_id(save_thread_), kSaveWakeFlag);
+    return true;
+}
+
+// Each buffer holds the largest payload a slot can, so a state that grows
+// never needs them reallocated while the writer is running.
+bool FX::saveStageAlloc_() {
+    if(save_stage_) return true;
+
+    const uint16_t capacity = kSaveSlotSize - kSaveSlotHeader;
+
+    save_stage_ = (uint8_t*)malloc((size_t)capacity * 3u);
+    save_latest_ = (uint8_t*)malloc(capacity);
+    if(!save_stage_ || !save_latest_) {
+        saveStageFree_();
+        return false;
+    }
+    save_stage_size_ = capacity;
+    memset(save_stage_len_, 0, sizeof(save_stage_len_));
+    save_latest_len_ = 0;
+    save_front_ = 0;
+    save_middle_ = 1;
+    save_back_ = 2;
+    return true;
+}
+
+void FX::saveStageFree_() {
+    if(save_stage_) {
+        free(save_stage_);
+        save_stage_ = nullptr;
+    }
+    if(save_latest_) {
+        free(save_latest_);
+        save_latest_ = nullptr;
+    }
+    save_stage_size_ = 0;
+    save_latest_len_ = 0;
+}
+
+// Reads and checks one slot into stage buffer `slot`.
+bool FX::saveSlotRead_(uint8_t slot, uint32_t* seq) {
+    uint8_t hdr[kSaveSlotHeader];
+    if(!fileReadAt_(save_slots_file_, (uint32_t)slot * kSaveSlotSize, hdr, sizeof(hdr))) return false;
+    if(memcmp(hdr, "FXSV", 4) != 0) return false;
+
+    const uint16_t size = (uint16_t)(hdr[8] | (hdr[9] << 8));
+    if(size == 0 || size > save_stage_size_) return false;
+
+    uint8_t* payload = save_stage_ + (size_t)slot * save_stage_size_;
+    if(storage_file_read(save_slots_file_, payload, size) != size) return false;
+    const uint32_t crc = fx_crc32(fx_crc32(0, hdr, 12), payload, size);
+    if(crc != fx_pack_le32(hdr + 12)) return false;
+
+    save_stage_len_[slot] = size;
+    *seq = fx_pack_le32(hdr + 4);
+    return true;
+}
+
+bool FX::saveSlotWrite_(uint8_t slot, uint32_t seq, const uint8_t* payload, uint16_t size) {
+    uint8_t hdr[kSaveSlotHeader];
+    memcpy(hdr, "FXSV", 4);
+    for(uint8_t i = 0; i < 4; i++)
+        hdr[4 + i] = (uint8_t)(seq >> (8u * i));
+    hdr[8] = (uint8_t)size;
+    hdr[9] = (uint8_t)(size >> 8);
+    hdr[10] = 0;
+    hdr[11] = 0;
+    const uint32_t crc = fx_crc32(fx_crc32(0, hdr, 12), payload, size);
+    for(uint8_t i = 0; i < 4; i++)
+        hdr[12 + i] = (uint8_t)(crc >> (8u * i));
+
+    if(!fileWriteAt_(save_slots_file_, (uint32_t)slot * kSaveSlotSize, hdr, sizeof(hdr))) return false;
+    if(storage_file_write(save_slots_file_, payload, size) != size) return false;
+    return storage_file_sync(save_slots_file_);
+}
+
+void FX::saveSlotsScan_() {
+    save_seq_ = 0;
+    save_disk_slot_ = 1;
+
+    uint32_t seq[2] = {0, 0};
+    const bool ok0 = saveSlotRead_(0, &seq[0]);
+    const bool ok1 = saveSlotRead_(1, &seq[1]);
+    if(!ok0 && !ok1) return;
+
+    const uint8_t best = (!ok1 || (ok0 && (int32_t)(seq[0] - seq[1]) > 0)) ? 0 : 1;
+    memcpy(save_latest_, save_stage_ + (size_t)best * save_stage_size_, save_stage_len_[best]);
+    save_latest_len_ = save_stage_len_[best];
+    save_seq_ = seq[best];
+    save_disk_slot_ = best;
+}
+
+bool FX::saveWriterStart_() {
+    if(save_running_) return true;
+    if(!storage_) return false;
+    if(!saveStageAlloc_()) return false;
+
+    save_slots_file_ = storage_file_alloc(storage_);
+    if(!save_slots_file_) return false;
+    if(!storage_file_open(save_slots_file_, kSaveSlotsPath, FSAM_READ_WRITE, FSOM_OPEN_ALWAYS)) {
+        storage_file_free(save_slots_file_);
+        save_slots_file_ = nullptr;
+        saveStageFree_();
+        return false;
+    }
+    saveSlotsScan_();
+
+    save_thread_ = furi_thread_alloc();
+    if(!save_thread_) {
+        saveWriterStop_();
+        return false;
+    }
+    __atomic_store_n(&save_running_, true, __ATOMIC_RELEASE);
+    furi_thread_set_name(save_thread_, "ArdulibFxSave");
+    furi_thread_set_stack_size(save_thread_, 1024);
+    furi_thread_set_priority(save_thread_, FuriThreadPriorityLow);
+    furi_thread_set_callback(save_thread_, saveWriterThread_);
+    furi_thread_start(save_thread_);
+
+    return true;
+}
+
+// Joins the writer after it has written whatever is still queued.
+void FX::saveWriterStop_() {
+    __atomic_store_n(&save_running_, false, __ATOMIC_RELEASE);
+    if(save_thread_) {
+        furi_thread_flags_set(furi_thread_get_id(save_thread_), kSaveWakeFlag);
+        furi_thread_join(save_thread_);
+        furi_thread_free(save_thread_);
+        save_thread_ = nullptr;
+    }
+    if(save_slots_file_) {
+        storage_file_close(save_slots_file_);
+        storage_file_free(save_slots_file_);
+        save_slots_file_ = nullptr;
+    }
+    saveStageFree_();
+}
+
+void FX::saveWriterDrain_() {
+    while(__atomic_load_n(&save_middle_, __ATOMIC_ACQUIRE) & kSaveStageNew) {
+        save_back_ = (uint8_t)(__atomic_exchange_n(&save_middle_, save_back_, __ATOMIC_ACQ_REL) &
+                               ~kSaveStageNew);
+        const uint8_t slot = (uint8_t)(save_disk_slot_ ^ 1u);
+        const uint8_t* payload = save_stage_ + (size_t)save_back_ * save_stage_size_;
+        if(saveSlotWrite_(slot, save_stage_seq_[save_back_], payload, save_stage_len_[save_back_]))
+            save_disk_slot_ = slot;
+    }
+}
+
+int32_t FX::saveWriterThread_(void* context) {
+    UNUSED(context);
+    while(__atomic_load_n(&save_running_, __ATOMIC_ACQUIRE)) {
+        furi_thread_flags_wait(kSaveWakeFlag, FuriFlagWaitAny, FuriWaitForever);
+        saveWriterDrain_();
+    }
+    saveWriterDrain_();
+    return 0;
 }
 
 void FX::warmUpData(uint32_t address, size_t length) {
@@ -777,6 +1650,42 @@ void FX::warmUpData(uint32_t address, size_t length) {
     }
 }
 
+// Speculative variant of warmUpData: pages are queued on the prefetch worker
+// and the call returns immediately. Low priority hints keep half of the ring
+// free for sequential read-ahead; resident pages are refreshed in the LRU for
+// normal and high priority. Without a worker only high priority hints load,
+// synchronously.
+void FX::hintRange(uint24_t address, uint32_t length, uint8_t priority) {
+    if(!cache_mem_ || length == 0) return;
+    if(prefetch_retire_ != prefetch_head_) prefetchCollect_();
+
+    const uint32_t abs = absDataOffset_(address);
+    const uint32_t end = abs + length;
+    const uint8_t limit = (priority == hintLow) ? (uint8_t)(kPrefetchRingSize / 2u) : kPrefetchRingSize;
+
+    for(uint32_t p = alignDown_(abs, page_size_); p < end; p += page_size_) {
+        if(dataPageHas_(p)) {
+            if(priority != hintLow) lruTouch_(last_hit_);
+            continue;
+        }
+        if(prefetch_running_) {
+            if((uint8_t)(prefetch_head_ - prefetch_retire_) >= limit) return;
+            if(!prefetchRequest_(p)) return;
+        } else if(priority == hintHigh) {
+            if(!dataLoadPage_(p, dataPickVictim_())) return;
+        } else {
+            return;
+        }
+    }
+}
+
+void FX::hintBitmapFrame(uint24_t bitmap_addr, uint8_t frame, uint8_t mode, uint8_t priority) {
+    const BitmapMetaCacheEntry* meta = getBitmapMeta_(bitmap_addr);
+    if(!meta) return;
+    const uint32_t stride = (mode & dbmMasked) ? meta->masked_stride : meta->frame_stride;
+    hintRange(bitmap_addr + 4u + (uint32_t)frame * stride, stride, priority);
+}
+
 void FX::waitWhileBusy() {
 }
 
@@ -784,7 +1693,9 @@ void FX::writeSavePage(uint16_t page, const uint8_t* buffer) {
     if(!save_opened_ || !save_ || !buffer) return;
     const uint32_t off = (uint32_t)page * 256u;
     if(off >= (uint32_t)kSaveBlockSize) return;
-    (void)fileWriteAt_(save_, off, buffer, fx_min_sz(256u, (size_t)(kSaveBlockSize - off)));
+    const size_t len = fx_min_sz(256u, (size_t)(kSaveBlockSize - off));
+    memcpy(save_mem_ + off, buffer, len);
+    saveMarkDirty_(off, len);
 }
 
 void FX::setFrame(uint24_t frame_addr, uint8_t frame_count) {
@@ -843,12 +1754,89 @@ bool FX::drawFrame(uint24_t frame_addr) {
     return drawFrame();
 }
 
-void FX::drawBitmap(int16_t x, int16_t y, uint24_t bitmap_addr, uint8_t frame, uint8_t mode) {
+void FX::bitmapMetaReset_() {
+    memset(bitmap_meta_cache_, 0, sizeof(bitmap_meta_cache_));
+    bitmap_meta_rr_ = 0;
+}
+
+const FX::BitmapMetaCacheEntry* FX::getBitmapMeta_(uint24_t bitmap_addr) {
+    const uint8_t home = (uint8_t)(((bitmap_addr * 2654435761u) >> 24) & (kBitmapMetaCacheSize - 1u));
+    for(uint8_t i = 0; i < kBitmapMetaCacheWays; i++) {
+        const BitmapMetaCacheEntry& e = bitmap_meta_cache_[(home + i) & (kBitmapMetaCacheSize - 1u)];
+        if(e.valid && e.addr == bitmap_addr) {
+            bitmap_meta_stats_.hits++;
+            return &e;
+        }
+    }
+    bitmap_meta_stats_.misses++;
+
     uint8_t wh[4] = {0, 0, 0, 0};
-    if(!readDataAt_(bitmap_addr, wh, sizeof(wh))) return;
+    if(!readDataAt_(bitmap_addr, wh, sizeof(wh))) return nullptr;
+
+    uint8_t way = kBitmapMetaCacheWays;
+    for(uint8_t i = 0; i < kBitmapMetaCacheWays; i++) {
+        if(!bitmap_meta_cache_[(home + i) & (kBitmapMetaCacheSize - 1u)].valid) {
+            way = i;
+            break;
+        }
+    }
+    if(way == kBitmapMetaCacheWays) way = (uint8_t)(bitmap_meta_rr_++ & (kBitmapMetaCacheWays - 1u));
+
+    BitmapMetaCacheEntry& e = bitmap_meta_cache_[(home + way) & (kBitmapMetaCacheSize - 1u)];
+    e.addr = bitmap_addr;
+    e.w = fx_be16(&wh[0]);
+    e.h = fx_be16(&wh[2]);
+    e.rows = (uint16_t)((e.h + 7u) >> 3);
+    e.frame_stride = (uint32_t)e.rows * (uint32_t)e.w;
+    e.masked_stride = e.frame_stride << 1;
+    e.valid = 1;
+    return &e;
+}
+
+void FX::getBitmapMetaStats(BitmapMetaStats& stats) {
+    stats = bitmap_meta_stats_;
+}
+
+void FX::resetBitmapMetaStats() {
+    bitmap_meta_stats_.hits = 0;
+    bitmap_meta_stats_.misses = 0;
+}
+
+void FX::drawBitmap(int16_t x, int16_t y, uint24_t bitmap_addr, uint8_t frame, uint8_t mode) {
+    const BitmapMetaCacheEntry* meta = getBitmapMeta_(bitmap_addr);
+    if(!meta) return;
+
+    if(draw_list_active_) {
+        if(x + (int16_t)meta->w <= 0 || x >= WIDTH || y + (int16_t)meta->h <= 0 || y >= HEIGHT) return;
+        if(draw_list_len_ == kDrawListSize) {
+            drawListRun_();
+        }
+        const uint32_t stride = (mode & dbmMasked) ? meta->masked_stride : meta->frame_stride;
+        DrawCommand& c = draw_list_[draw_list_len_++];
+        c.addr = bitmap_addr;
+        c.data = bitmap_addr + 4u + (uint32_t)frame * stride;
+        c.x = x;
+        c.y = y;
+        c.w = meta->w;
+        c.h = meta->h;
+        c.frame = frame;
+        c.mode = mode;
+        c.layer = draw_layer_;
+        return;
+    }
 
-    int16_t width = (int16_t)fx_be16(&wh[0]);
-    int16_t height = (int16_t)fx_be16(&wh[2]);
+    drawBitmapMeta_(meta, x, y, bitmap_addr, frame, mode);
+}
+
+void FX::drawBitmapMeta_(
+    const BitmapMetaCacheEntry* meta,
+    int16_t x,
+    int16_t y,
+    uint24_t bitmap_addr,
+    uint8_t frame,
+    uint8_t mode) {
+    int16_t width = (int16_t)meta->w;
+    int16_t height = (int16_t)meta->h;
     if(width <= 0 || height <= 0) return;
     if(x + width <= 0 || x >= WIDTH || y + height <= 0 || y >= HEIGHT) return;
 
@@ -875,13 +1863,12 @@ void FX::drawBitmap(int16_t x, int16_t y, uint24_t bitmap_addr, uint8_t frame, u
     }
     if(renderheight <= 0) return;
 
-    const uint16_t rows_per_frame = (uint16_t)((height + 7) >> 3);
-    uint32_t offset = (uint32_t)((uint32_t)frame * (uint32_t)rows_per_frame + (uint32_t)skiptop) *
-                          (uint32_t)width +
-                      (uint32_t)skipleft;
+    uint32_t offset = (uint32_t)skiptop * (uint32_t)width + (uint32_t)skipleft;
     if(mode & dbmMasked) {
-        offset += offset;
+        offset = (uint32_t)frame * meta->masked_stride + (offset << 1);
         width += width;
+    } else {
+        offset += (uint32_t)frame * meta->frame_stride;
     }
 
     uint32_t address = bitmap_addr + 4u + offset;
@@ -889,85 +1876,164 @@ void FX::drawBitmap(int16_t x, int16_t y, uint24_t bitmap_addr, uint8_t frame, u
     const int16_t base_x = (int16_t)(x + skipleft);
 
     const uint8_t shift = (uint8_t)(y & 7);
-    const uint8_t yshift = (uint8_t)(1u << shift);
+    const FxBlitRowFn blit = fx_blit_pick(mode, shift != 0);
     const uint8_t lastmask = (uint8_t)((height & 7) ? ((1u << (height & 7)) - 1u) : 0xFFu);
     uint8_t* const screen = arduboy.getBuffer();
     if(!screen) return;
 
-    uint8_t rowbuf_local[256];
-    uint8_t* rowbuf = rowbuf_local;
-    size_t rowbuf_cap = sizeof(rowbuf_local);
+    static_assert(kDrawScratchSize >= 2u * WIDTH, "draw_scratch_ must hold a masked screen row");
+    // Only the visible columns of a row are fetched: at most WIDTH columns,
+    // two bytes each when masked, so draw_scratch_ always fits.
+    const uint32_t row_stride = (uint32_t)width;
+    const size_t row_bytes = (mode & dbmMasked) ? (size_t)renderwidth * 2u : (size_t)renderwidth;
 
     while(renderheight > 0) {
         const uint8_t rowmask = (renderheight < 8) ? lastmask : 0xFFu;
-        const bool extra_row = (yshift != 1u) && (displayrow < ((HEIGHT / 8) - 1));
-        const uint32_t row_bytes = (uint32_t)width;
-
-        if(row_bytes == 0) break;
-        if(row_bytes > rowbuf_cap) {
-            if(rowbuf != rowbuf_local) free(rowbuf);
-            rowbuf = (uint8_t*)malloc((size_t)row_bytes);
-            if(!rowbuf) return;
-            rowbuf_cap = (size_t)row_bytes;
-        }
-        if(!readDataAt_(address, rowbuf, (size_t)row_bytes)) {
-            if(rowbuf != rowbuf_local) free(rowbuf);
-            return;
+        const bool extra_row = (shift != 0u) && (displayrow < ((HEIGHT / 8) - 1));
+
+        // Rows inside one cached page are blitted in place; a row that
+        // straddles two pages is copied into the scratch buffer.
+        const uint8_t* src;
+        if(alignDown_(address, page_size_) == alignDown_(address + (uint32_t)row_bytes - 1u, page_size_)) {
+            src = dataPtrAt_(address, row_bytes);
+            if(!src) return;
+        } else {
+            if(!readDataAt_(address, draw_scratch_, row_bytes)) return;
+            src = draw_scratch_;
         }
-        address += row_bytes;
+        address += row_stride;
 
-        uint16_t src = 0;
-        for(uint8_t c = 0; c < renderwidth; c++) {
-            uint8_t bitmapbyte = rowbuf[src++];
-            if(mode & (1u << dbfReverseBlack)) bitmapbyte ^= rowmask;
+        FxBlitRow row;
+        row.src = src;
+        row.dst0 = ((uint16_t)displayrow < (HEIGHT / 8)) ? screen + displayrow * WIDTH + base_x : nullptr;
+        row.dst1 = extra_row ? screen + (displayrow + 1) * WIDTH + base_x : nullptr;
+        row.count = renderwidth;
+        row.rowmask = rowmask;
+        row.shift = shift;
+        if(row.dst0 || row.dst1) blit(row, mode);
 
-            uint8_t maskbyte = rowmask;
-            if(mode & (1u << dbfWhiteBlack)) maskbyte = bitmapbyte;
-            if(mode & (1u << dbfBlack)) bitmapbyte = 0;
+        displayrow++;
+        renderheight -= 8;
+    }
+}
 
-            const uint16_t bitmap = (uint16_t)bitmapbyte * (uint16_t)yshift;
+void FX::beginDrawList() {
+    draw_list_active_ = true;
+    draw_layer_ = 0;
+    draw_list_stats_.last_changes_saved = 0;
+    draw_list_stats_.last_page_misses = 0;
+}
 
-            if(mode & dbmMasked) {
-                uint8_t tmp = rowbuf[src++];
-                if((mode & (1u << dbfWhiteBlack)) == 0u) maskbyte = tmp;
-            }
+void FX::setDrawLayer(uint8_t layer) {
+    draw_layer_ = layer;
+}
 
-            const uint16_t mask = (uint16_t)maskbyte * (uint16_t)yshift;
-            const int16_t sx = (mode & (1u << dbfFlip)) ? (int16_t)(base_x + renderwidth - 1 - c) :
-                                                          (int16_t)(base_x + c);
-            if((uint16_t)sx >= WIDTH) continue;
-
-            if((uint16_t)displayrow < (HEIGHT / 8)) {
-                const uint16_t idx = (uint16_t)(displayrow * WIDTH + sx);
-                uint8_t display = screen[idx];
-                uint8_t pixels = (uint8_t)(bitmap & 0xFFu);
-                if((mode & (1u << dbfInvert)) == 0u) pixels ^= display;
-                pixels &= (uint8_t)(mask & 0xFFu);
-                pixels ^= display;
-                screen[idx] = pixels;
-            }
+void FX::flushDrawList() {
+    if(!draw_list_active_) return;
+    drawListRun_();
+    draw_list_active_ = false;
+    draw_list_stats_.flushes++;
+}
 
-            if(extra_row) {
-                const int16_t row2 = (int16_t)(displayrow + 1);
-                if((uint16_t)row2 >= (HEIGHT / 8)) continue;
-                const uint16_t idx2 = (uint16_t)(row2 * WIDTH + sx);
-                uint8_t display = screen[idx2];
-                uint8_t pixels = (uint8_t)(bitmap >> 8);
-                if((mode & (1u << dbfInvert)) == 0u) pixels ^= display;
-                pixels &= (uint8_t)(mask >> 8);
-                pixels ^= display;
-                screen[idx2] = pixels;
+// Rows are compared in whole screen pages: a draw at a sub-byte y shift
+// writes the pages it touches.
+bool FX::drawListOverlap_(const DrawCommand& a, const DrawCommand& b) {
+    if(a.x >= b.x + (int16_t)b.w || b.x >= a.x + (int16_t)a.w) return false;
+    const int16_t a0 = (int16_t)(a.y & ~7), a1 = (int16_t)(a.y + (int16_t)a.h + 7);
+    const int16_t b0 = (int16_t)(b.y & ~7), b1 = (int16_t)(b.y + (int16_t)b.h + 7);
+    return !((a1 & ~7) <= b0 || (b1 & ~7) <= a0);
+}
+
+// Draws and empties the list, layer by layer. Within a layer a draw waits
+// for the earlier draws it overlaps; of the draws that are free to go, one
+// on the page just drawn from goes first, otherwise the lowest frame data
+// address. A list is short, so the scans are cheaper than one page miss.
+void FX::drawListRun_() {
+    const uint8_t n = draw_list_len_;
+    draw_list_len_ = 0;
+    if(n == 0) return;
+
+    uint16_t changes_recorded = 0;
+    for(uint8_t i = 1; i < n; i++) {
+        if(alignDown_(draw_list_[i].data, page_size_) != alignDown_(draw_list_[i - 1].data, page_size_))
+            changes_recorded++;
+    }
+
+    for(uint8_t i = 0; i < n; i++) {
+        draw_waits_[i] = 0;
+        for(uint8_t j = 0; j < i; j++) {
+            if(draw_list_[j].layer == draw_list_[i].layer && drawListOverlap_(draw_list_[j], draw_list_[i]))
+                draw_waits_[i]++;
+        }
+    }
+
+    const uint32_t misses_before = page_misses_;
+    uint16_t changes_drawn = 0;
+    uint32_t last_page = UINT32_MAX;
+    uint24_t last_addr = 0;
+    const BitmapMetaCacheEntry* meta = nullptr;
+    uint8_t left = n;
+
+    while(left > 0) {
+        uint8_t layer = 0xFF;
+        for(uint8_t i = 0; i < n; i++) {
+            if(draw_waits_[i] != kDrawDone && draw_list_[i].layer < layer) layer = draw_list_[i].layer;
+        }
+
+        uint8_t pick = kDrawDone;
+        for(uint8_t i = 0; i < n; i++) {
+            const DrawCommand& c = draw_list_[i];
+            if(draw_waits_[i] != 0 || c.layer != layer) continue;
+            if(alignDown_(c.data, page_size_) == last_page) {
+                pick = i;
+                break;
             }
+            if(pick == kDrawDone || c.data < draw_list_[pick].data) pick = i;
         }
 
-        displayrow++;
-        renderheight -= 8;
+        const DrawCommand& c = draw_list_[pick];
+        const uint32_t page = alignDown_(c.data, page_size_);
+        if(last_page != UINT32_MAX && page != last_page) changes_drawn++;
+        last_page = page;
+
+        if(!meta || c.addr != last_addr) {
+            meta = getBitmapMeta_(c.addr);
+            last_addr = c.addr;
+            draw_list_stats_.batches++;
+        }
+        if(meta) drawBitmapMeta_(meta, c.x, c.y, c.addr, c.frame, c.mode);
+
+        draw_waits_[pick] = kDrawDone;
+        left--;
+        for(uint8_t j = pick + 1; j < n; j++) {
+            if(draw_waits_[j] != kDrawDone && draw_list_[j].layer == c.layer && drawListOverlap_(c, draw_list_[j]))
+                draw_waits_[j]--;
+        }
     }
 
-    if(rowbuf != rowbuf_local) free(rowbuf);
+    const uint16_t misses = (uint16_t)(page_misses_ - misses_before);
+    draw_list_stats_.draws += n;
+    draw_list_stats_.changes_recorded += changes_recorded;
+    draw_list_stats_.changes_drawn += changes_drawn;
+    draw_list_stats_.page_misses += misses;
+    if(changes_recorded > changes_drawn)
+        draw_list_stats_.last_changes_saved += (uint16_t)(changes_recorded - changes_drawn);
+    draw_list_stats_.last_page_misses += misses;
+}
+
+void FX::getDrawListStats(DrawListStats& stats) {
+    stats = draw_list_stats_;
+}
+
+void FX::resetDrawListStats() {
+    draw_list_stats_ = {0, 0, 0, 0, 0, 0, 0, 0};
 }
 
 void FX::display(bool clear) {
+    flushDrawList();
+#ifdef ARDULIB_FX_TRACE
+    trace_frame_++;
+#endif
     arduboy.display(clear);
 }
 
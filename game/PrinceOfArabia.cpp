@@ -31,6 +31,28 @@ uint8_t startLevel = STARTING_LEVEL;
 #endif
 
 Cookie cookie;
+// Also holds a save from before the serializer, see loadCookie() ..
+constexpr uint16_t Cookie_LegacySize = sizeof(Cookie) + Level::LegacyWindowSize;
+uint8_t cookieBuffer[Cookie::SaveSize > Cookie_LegacySize ? Cookie::SaveSize : Cookie_LegacySize];
+int8_t Level::bg[Constants::Level_Tiles_Max];
+int8_t Level::fg[Constants::Level_Tiles_Max];
+
+uint8_t StanceTables::imageXRef[StanceTables::ImageXRef_Size];
+int8_t StanceTables::offsets[StanceTables::Offsets_Size];
+uint8_t StanceTables::vertAdjustments[StanceTables::VertAdjustments_Size];
+uint8_t StanceTables::imageDetails[StanceTables::ImageDetails_Size];
+uint16_t StanceTables::runningJumps[StanceTables::RunningJumps_Count][StanceTables::Jump_Length];
+uint16_t StanceTables::standingJumps[StanceTables::StandingJumps_Count][StanceTables::Jump_Length];
+uint16_t StanceTables::jumpFromFX[StanceTables::Jump_Length];
+StanceTables::Stats StanceTables::stats = { 0, 0, 0, 0 };
+uint8_t BackgroundCache::layer[BackgroundCache::Layer_Size];
+BackgroundCache::Torch BackgroundCache::torches[BackgroundCache::Torches_Max];
+uint8_t BackgroundCache::torchCount = 0;
+bool BackgroundCache::valid = false;
+BackgroundCache::Stats BackgroundCache::stats = { 0, 0, 0, 0 };
+Level::VisibleItem Level::visibleItems[Constants::Items_Count];
+uint8_t Level::visibleItemCount = 0;
+bool Level::visibleItemsValid = false;
 Stack <int16_t, Constants::StackSize> princeStack;
 Prince &prince = cookie.prince;
 Stack <int16_t, Constants::StackSize> enemyStack;
@@ -9,13 +9,13 @@ const uint8_t speed[] PROGMEM = {  1,  1,  2,  3,  4,  4,  5,  5,  6,  6,  7,  8
 
 void invader_NewWave(Invader_General2 &general2) {
 
-    FX::seekData(FX::readIndexedUInt24(Levels::Level_Items, 0) + 16);
+    FX::Reader reader(FX::readIndexedUInt24(Levels::Level_Items, 0) + 16);
 
     for(uint8_t x = 0; x < 21 + 16; x++) {  // enemies + barriers
 
         Item &item = level.getItem(Constants::Invaders_Enemy_Row_1_Start + x);
-        item.itemType = static_cast<ItemType>(FX::readPendingUInt8());
-        FX::readBytes((uint8_t*)&item.data.rawData, sizeof(item.data.rawData));
+        item.itemType = static_cast<ItemType>(reader.readUInt8());
+        reader.readBytes((uint8_t*)&item.data.rawData, sizeof(item.data.rawData));
 
         if (x < 21) {
             item.data.invader_Enemy.y = item.data.invader_Enemy.y - 24 + general2.launchOffset;
@@ -23,8 +23,6 @@ void invader_NewWave(Invader_General2 &general2) {
 
     }
 
-    FX::readEnd();
-
     #ifndef SAVE_MEMORY_SOUND
         setSound(SoundIndex::Invader_Wave_Start);
     #endif 
@@ -1044,6 +1044,7 @@ void game() {
                                 uint8_t idx = static_cast<uint8_t>(item.itemType) - static_cast<uint8_t>(ItemType::Potion_Small); 
                                 prince.pushSequence(Stance::Drink_Tonic_Small_1_Start + (idx * 15), Stance::Drink_Tonic_Small_15_End + (idx * 15), Stance::Upright);
                                 item.itemType = ItemType::None;
+                                level.invalidateVisibleItems();
 
                                 break;
 
@@ -1059,6 +1060,7 @@ void game() {
 
                                 Item &item = level.getItem(itemIdx);
                                 item.itemType = ItemType::None;
+                                level.invalidateVisibleItems();
                                 prince.setSword(true);
                                 prince.clear();
                                 prince.pushSequence(Stance::Pickup_Sword_1_Start, Stance::Pickup_Sword_16_End, Stance::Upright);
@@ -1260,7 +1262,7 @@ void game() {
 
                             case MenuOption::Load:
 
-                                if(FX::loadGameState(cookie)) {
+                                if(loadCookie()) {
                                     restoreRuntimeAfterLoad();
 
                                     // Resume play from loaded world state.
@@ -2043,6 +2045,7 @@ void game() {
                                                 if (enemy.activateEnemy(item.data.location.x, item.data.location.y)) {
 
                                                     item.itemType = ItemType::None;
+                                                    level.invalidateVisibleItems();
 
                                                 }
 
@@ -2289,6 +2292,7 @@ void game() {
                             gate.data.gate.closingDelayMax = 255;
                             gate.data.gate.movement = GateMovement::GoingDown;
                             gate.itemType = ItemType::Gate_StayClosed;           
+                            level.invalidateVisibleItems();
                         }
                         break;
 
@@ -2525,12 +2529,9 @@ void game() {
             adj = 31 - adj;
             adj = (adj - 1) * 5;
 
-            uint24_t startPos = Constants::VertAdjustments + adj;
-            FX::seekData(startPos);
-
             for (uint8_t i = adj; i < adj + 5; i++) {
                 
-                uint8_t adjustment = FX::readPendingUInt8();
+                uint8_t adjustment = StanceTables::getVertAdjustment(i);
 
                 if (adjustment > 0) {
 
@@ -2547,8 +2548,6 @@ void game() {
 
             }
 
-            FX::readEnd();
-
         }
 
         #if defined(DEBUG) && defined(DEBUG_VERT_ADJ)
@@ -2624,6 +2623,8 @@ void game() {
     }
     #endif
 
+    FX::flushDrawList();
+
     #if defined(DEBUG) && defined(DEBUG_ONSCREEN_DETAILS)
     font3x5.setTextColor(0);
     arduboy.fillRect(0, 0, 128, 7);
@@ -9,48 +9,73 @@
 
 void render(bool sameLevelAsPrince) {
 
+    FX::setTraceTag(FxTraceTagRender);
 
-    // Draw background and collapsed tiles ..
 
-    for (uint8_t y = 0; y < 4; y++) {
+    // Draw background and collapsed tiles.  The cached layer covers every
+    // yOffset a scroll passes through, so scrolling is a shifted copy ..
 
-        for (int8_t x = 9; x >= 0; x--) {
+    uint8_t *screen = arduboy.getBuffer();
+    uint8_t yOffset = level.getYOffset();
 
-            int8_t bgTile = level.getTile(Layer::Background, x, y - 1, TILE_NONE);
-            int16_t yCoord = (y * Constants::TileHeight) - level.getYOffset() - Constants::TileHeight + Constants::ScreenTopOffset;
+    if (yOffset <= BackgroundCache::YOffset_Max) {
 
-            switch (bgTile) {
+        if (!BackgroundCache::isValid()) {
 
-                case 0 ... 123:
-                   FX::drawBitmap(x * Constants::TileWidth, yCoord, Images::Tiles_Dungeon, bgTile, dbmMasked);
-                   break;
+            renderBackgroundTiles(0);
+            BackgroundCache::storeTop(screen);
 
-                case 124:
-                case 127:
-                   FX::drawBitmap(x * Constants::TileWidth, yCoord, Images::Tiles_Dungeon_Torch, (arduboy.getFrameCount(15, (x + 2)) / 5), dbmNormal);
-                   break;
+            memset(screen, 0, BackgroundCache::Screen_Size);
+            renderBackgroundTiles(BackgroundCache::YOffset_Max);
+            BackgroundCache::storeBottom(screen);
 
-            }
-            
-            // Draw foreground, collapsed tiles ..
+        }
 
-            int8_t fgTile = level.getTile(Layer::Foreground, x, y - 1, TILE_NONE);
+        BackgroundCache::restore(screen, yOffset);
+
+    }
+    else {
 
-            if      (fgTile == Constants::Tile_CollapsedTile_Full) FX::drawBitmap(x * Constants::TileWidth, yCoord, Images::Tile_Dungeon_97, 0, dbmMasked);
-            else if (fgTile == Constants::Tile_CollapsedTile_Half) FX::drawBitmap(x * Constants::TileWidth, yCoord, Images::Tile_Dungeon_98, 0, dbmMasked);
+        renderBackgroundTiles(yOffset);
+        BackgroundCache::countDirect();
 
-        }
+    }
+
+
+    // The rest of the frame is recorded, and drawn ordered by FX page once
+    // game() flushes the list ..
+
+    FX::beginDrawList();
+
+
+    // Torches are drawn over the cached layer.  A collapsed tile in the same
+    // cell, or one to the left (Tile_Dungeon_97 is wider than a tile), was
+    // drawn after the torch originally so it is drawn again on top ..
+
+    for (uint8_t i = 0; i < BackgroundCache::getTorchCount(); i++) {
+
+        const BackgroundCache::Torch &torch = BackgroundCache::getTorch(i);
+        int16_t yCoord = ((torch.y + 1) * Constants::TileHeight) - yOffset - Constants::TileHeight + Constants::ScreenTopOffset;
+
+        FX::drawBitmap(torch.x * Constants::TileWidth, yCoord, Images::Tiles_Dungeon_Torch, (arduboy.getFrameCount(15, (torch.x + 2)) / 5), dbmNormal);
+        renderCollapsedTile(torch.x, torch.y, yOffset);
+        if (torch.x > 0) renderCollapsedTile(torch.x - 1, torch.y, yOffset);
 
     }
 
 
-    // Draw items ..
+    // Draw items.  Only those the room can show are visited ..
+
+    level.updateVisibleItems();
 
-    for (uint8_t i = 0; i < Constants::Items_Count; i++) {
+    for (uint8_t i = 0; i < level.getVisibleItemCount(); i++) {
 
-        Item &item = level.getItem(i);
-        int16_t xLoc = (item.data.location.x - level.getXLocation()) * Constants::TileWidth;
-        int16_t yLoc = ((item.data.location.y - level.getYLocation()) * Constants::TileHeight) - level.getYOffset() + Constants::ScreenTopOffset;
+        Level::VisibleItem &visibleItem = level.getVisibleItem(i);
+        if (!(visibleItem.passes & Level::VisibleItem::Background)) continue;
+
+        Item &item = level.getItem(visibleItem.idx);
+        int16_t xLoc = visibleItem.x;
+        int16_t yLoc = visibleItem.y - level.getYOffset();
 
         //if (item.itemType != ItemType::None) {
 
@@ -206,7 +231,7 @@ void render(bool sameLevelAsPrince) {
         if (enemy.getStatus() == Status::Active) {
                 
             uint16_t stance = enemy.getStance();
-            uint8_t imageIndex = getImageIndexFromStance(stance);
+            uint8_t imageIndex = StanceTables::getImageIndex(stance);
 
             if (imageIndex != 0) {
 
@@ -254,7 +279,7 @@ void render(bool sameLevelAsPrince) {
     // Draw prince ..
 
     uint16_t stance = prince.getStance();
-    uint8_t imageIndex = getImageIndexFromStance(stance);
+    uint8_t imageIndex = StanceTables::getImageIndex(stance);
 
     if (imageIndex != 0) {
 
@@ -281,11 +306,14 @@ void render(bool sameLevelAsPrince) {
 
     // Draw items ..
 
-    for (uint8_t i = 0; i < Constants::Items_Count; i++) {
+    for (uint8_t i = 0; i < level.getVisibleItemCount(); i++) {
+
+        Level::VisibleItem &visibleItem = level.getVisibleItem(i);
+        if (!(visibleItem.passes & Level::VisibleItem::Foreground)) continue;
 
-        Item &item = level.getItem(i);
-        int16_t xLoc = (item.data.location.x - level.getXLocation()) * Constants::TileWidth;
-        int16_t yLoc = ((item.data.location.y - level.getYLocation()) * Constants::TileHeight) - level.getYOffset() + Constants::ScreenTopOffset;
+        Item &item = level.getItem(visibleItem.idx);
+        int16_t xLoc = visibleItem.x;
+        int16_t yLoc = visibleItem.y - level.getYOffset();
 
         //if (item.itemType != ItemType::None) {
 
@@ -385,11 +413,14 @@ void render(bool sameLevelAsPrince) {
 
     // Draw edge tiles ..
 
-    for (uint8_t i = 0; i < Constants::Items_Count; i++) {
+    for (uint8_t i = 0; i < level.getVisibleItemCount(); i++) {
 
-        Item &item = level.getItem(i);
-        int16_t xLoc = (item.data.location.x - level.getXLocation()) * Constants::TileWidth;
-        int16_t yLoc = ((item.data.location.y - level.getYLocation()) * Constants::TileHeight) - level.getYOffset() + Constants::ScreenTopOffset;
+        Level::VisibleItem &visibleItem = level.getVisibleItem(i);
+        if (!(visibleItem.passes & Level::VisibleItem::EdgeTile)) continue;
+
+        Item &item = level.getItem(visibleItem.idx);
+        int16_t xLoc = visibleItem.x;
+        int16_t yLoc = visibleItem.y - level.getYOffset();
 
         //if (item.itemType != ItemType::None) {
 
@@ -557,6 +588,8 @@ void render(bool sameLevelAsPrince) {
 
 void renderMenu() {
 
+    FX::setTraceTag(FxTraceTagMenu);
+
     #ifndef SAVE_MEMORY_OTHER
     
         uint16_t data = getMenuData(MenuRenderDataTable);
@@ -592,6 +625,51 @@ void renderNumber_Upright(uint8_t x, uint8_t y, uint8_t number) {
 
 }
 
+// Background tiles and collapsed tiles of the room, without torches, as
+// seen at the given yOffset.  Torch cells are listed in BackgroundCache ..
+
+void renderBackgroundTiles(uint8_t yOffset) {
+
+    BackgroundCache::begin();
+
+    for (uint8_t y = 0; y < 4; y++) {
+
+        for (int8_t x = 9; x >= 0; x--) {
+
+            int8_t bgTile = level.getTile(Layer::Background, x, y - 1, TILE_NONE);
+            int16_t yCoord = (y * Constants::TileHeight) - yOffset - Constants::TileHeight + Constants::ScreenTopOffset;
+
+            switch (bgTile) {
+
+                case 0 ... 123:
+                   FX::drawBitmap(x * Constants::TileWidth, yCoord, Images::Tiles_Dungeon, bgTile, dbmMasked);
+                   break;
+
+                case 124:
+                case 127:
+                   BackgroundCache::addTorch(x, y - 1);
+                   break;
+
+            }
+
+            renderCollapsedTile(x, y - 1, yOffset);
+
+        }
+
+    }
+
+}
+
+void renderCollapsedTile(int8_t x, int8_t y, uint8_t yOffset) {
+
+    int8_t fgTile = level.getTile(Layer::Foreground, x, y, TILE_NONE);
+    int16_t yCoord = ((y + 1) * Constants::TileHeight) - yOffset - Constants::TileHeight + Constants::ScreenTopOffset;
+
+    if      (fgTile == Constants::Tile_CollapsedTile_Full) FX::drawBitmap(x * Constants::TileWidth, yCoord, Images::Tile_Dungeon_97, 0, dbmMasked);
+    else if (fgTile == Constants::Tile_CollapsedTile_Half) FX::drawBitmap(x * Constants::TileWidth, yCoord, Images::Tile_Dungeon_98, 0, dbmMasked);
+
+}
+
 void renderTorches(uint8_t x1, uint8_t x2, uint8_t y) {
 
     uint8_t frame = arduboy.getFrameCount(15) / 5;
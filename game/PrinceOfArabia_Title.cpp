@@ -15,8 +15,9 @@ void setTitleFrame(TitleFrameIndex index) {
 
     // TitleFrameIndexTable layout is fixed: uint24_t addr (3 bytes) + uint8_t frame_count.
     // Do not use sizeof(uint24_t) here because in this port uint24_t is represented as uint32_t.
-    FX::seekDataArray(TitleFrameIndexTable, idx, 0, 4);
-    uint32_t data = FX::readPendingLastUInt32();
+    FX::Reader reader;
+    reader.seekArray(TitleFrameIndexTable, idx, 0, 4);
+    uint32_t data = reader.readUInt32();
     FX::setFrame((uint24_t)(data >> 8), (uint8_t)data);
 
 }
@@ -96,7 +97,7 @@ void title() {
 
                 cookie.pop = !cookie.pop;
 
-                FX::saveGameState((uint8_t*)&cookie, sizeof(cookie));
+                saveCookie(false);
 
             }
 
@@ -170,7 +171,7 @@ void title() {
 
                         case TitleScreenOptions::Resume:
 
-                            if(!FX::loadGameState(cookie)) break;
+                            if(!loadCookie()) break;
                             restoreRuntimeAfterLoad();
                             
                             gamePlay.gameState = GameState::Game;
@@ -30,7 +30,7 @@ bool testScroll(GamePlay &gamePlay, Prince &prince, Level &level) {
 
             prince.incY(- Constants::TileHeight * 3);
             level.setYLocation(level.getYLocation() + 3);
-            level.loadMap(gamePlay);
+            level.hintNeighbouringRooms();
             level.setYOffset(0);
             level.setYOffsetDir(Direction::None);
 
@@ -43,7 +43,7 @@ bool testScroll(GamePlay &gamePlay, Prince &prince, Level &level) {
 
         prince.incY(Constants::TileHeight * 3);
         level.setYLocation(level.getYLocation() - 3);
-        level.loadMap(gamePlay);
+        level.hintNeighbouringRooms();
         level.setYOffset(Constants::TileHeight);
         level.setYOffsetDir(Direction::None);
 
@@ -54,7 +54,7 @@ bool testScroll(GamePlay &gamePlay, Prince &prince, Level &level) {
 
         prince.incX(Constants::TileWidth * Constants::ScreenWidthInTiles);
         level.setXLocation(level.getXLocation() - 10);
-        level.loadMap(gamePlay);
+        level.hintNeighbouringRooms();
 
         if (gamePlay.level == 13 && level.getXLocation() == 0 && level.getYLocation() == 0) {
 
@@ -89,7 +89,7 @@ bool testScroll(GamePlay &gamePlay, Prince &prince, Level &level) {
 
         prince.incX(-Constants::TileWidth * Constants::ScreenWidthInTiles);
         level.setXLocation(level.getXLocation() + 10);
-        level.loadMap(gamePlay);
+        level.hintNeighbouringRooms();
 
         if (gamePlay.level == 8 && level.getXLocation() == 40 && level.getYLocation() == 3 && mouse.counter == 0) {
 
@@ -127,11 +127,11 @@ bool testScroll(GamePlay &gamePlay, Prince &prince, Level &level) {
 
 }
 
-void pushSequence() {
+void pushSequence(const uint16_t *sequence) {
 
-    uint16_t s1 = FX::readPendingUInt16();
-    uint16_t s2 = FX::readPendingUInt16();
-    uint16_t s3 = FX::readPendingUInt16();
+    uint16_t s1 = sequence[0];
+    uint16_t s2 = sequence[1];
+    uint16_t s3 = sequence[2];
 
     if (s1 != Stance::None) {
         prince.pushSequence(s1, s2, s3);
@@ -139,18 +139,17 @@ void pushSequence() {
 
 }
 
-void processJump(uint24_t pos) {
+void processJump(const uint16_t *jump) {
 
-    FX::seekData(pos);
-    pushSequence();
-    pushSequence();
-    uint16_t collision = FX::readPendingUInt16();
+    pushSequence(&jump[0]);
+    pushSequence(&jump[3]);
+    uint16_t collision = jump[6];
 
     if (collision == 1) {
         prince.setIgnoreWallCollisions(true);
     }
 
-    uint16_t counter = FX::readPendingLastUInt16();
+    uint16_t counter = jump[7];
 
     if (counter > 0) {
         prince.setHangingCounter(static_cast<uint8_t>(counter));
@@ -201,8 +200,7 @@ void processRunJump(Prince &prince, Level &level, bool testEnemy) {
 
     if (jumpResult != RunningJumpResult::KeepRunning) {
         
-        uint24_t pos = RunningJumpStances + static_cast<uint24_t>(static_cast<uint16_t>(jumpResult) * 16);
-        processJump(pos);
+        processJump(StanceTables::getRunningJump(jumpResult));
 
     }
     else {
@@ -215,8 +213,7 @@ void processStandingJump(Prince &prince, Level &level) {
 
     StandingJumpResult standingJumpResult = level.canStandingJump(prince);
 
-    uint24_t pos = StandingJumpStances + static_cast<uint24_t>(static_cast<uint16_t>(standingJumpResult) * 16);
-    processJump(pos);
+    processJump(StanceTables::getStandingJump(standingJumpResult));
 
 }
 
@@ -617,21 +614,12 @@ void fixPosition() {
 }
 
 
-uint8_t getImageIndexFromStance(uint16_t stance) {
-
-    FX::seekData(Constants::StanceToImageXRefFX + stance);
-    uint8_t image = FX::readEnd();
-
-    return image;
-    
-}
-
-
 void getStance_Offsets(Direction direction, Point &offset, int16_t stance) {
 
-    FX::seekData(Constants::Stance_XYOffsetsFX + ((stance - 1) * 2));
-    offset.x = static_cast<int8_t>(FX::readPendingUInt8()) * (direction == Direction::Left ? -1 : 1) * (stance < 0 ? -1 : 1);;
-    offset.y = static_cast<int8_t>(FX::readEnd()) * (stance < 0 ? -1 : 1);
+    int8_t x, y;
+    StanceTables::getOffsets(stance, x, y);
+    offset.x = x * (direction == Direction::Left ? -1 : 1) * (stance < 0 ? -1 : 1);
+    offset.y = y * (stance < 0 ? -1 : 1);
         
 }
 
@@ -663,7 +651,8 @@ void saveCookie(bool enableLEDs) {
     }
     #endif
 
-    FX::saveGameState(cookie);
+    uint16_t size = cookie.serialize(cookieBuffer, Cookie::SaveSize);
+    if (size) FX::saveGameStateAsync(cookieBuffer, size);
 
     #ifdef USE_LED
     if (enableLEDs) {
@@ -679,6 +668,32 @@ void saveCookie(bool enableLEDs) {
 
 }
 
+bool loadCookie() {
+
+    uint16_t size = FX::loadGameStateUpTo(cookieBuffer, Cookie::SaveSize);
+
+    if (size && cookieBuffer[0] == Cookie::SaveMagic) {
+        return cookie.deserialize(cookieBuffer, size);
+    }
+
+
+    // Saves from before the serializer are a copy of the struct as it was,
+    // with the level's bg / fg windows ahead of flash.  They start with the
+    // hasSavedLevel flag, never SaveMagic.  Drop the windows and load the
+    // level's tiles instead ..
+
+    if (!FX::loadGameState(cookieBuffer, Cookie_LegacySize)) return false;
+
+    uint16_t split = (uint8_t*)&level.getFlash() - (uint8_t*)&cookie;
+
+    memcpy(&cookie, cookieBuffer, split);
+    memcpy((uint8_t*)&cookie + split, cookieBuffer + split + Level::LegacyWindowSize, sizeof(Cookie) - split);
+
+    level.loadMap(gamePlay);
+    return true;
+
+}
+
 void bindRuntimeStacks() {
 
     if(prince.getStack() != &princeStack) {
@@ -753,7 +768,7 @@ void restoreRuntimeAfterLoad() {
         }
 
         if (playSound) {
-            sound.tonesFromFX(FX::readIndexedUInt24(Sounds::Table, (uint8_t)index));
+            sound.tonesFromFX(Sounds::Table, (uint8_t)index);
         }
         
     }
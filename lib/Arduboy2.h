@@ -91,10 +91,25 @@ public:
     uint8_t press_edges_ = 0;
     uint8_t release_edges_ = 0;
 
+    // Lateness of frames started by nextFrame(), in ms past their deadline.
+    // A frame more than one period late restarts the schedule instead.
+    struct FrameTimingStats {
+        uint32_t frames;
+        uint32_t late_ms_total;
+        uint32_t late_ms_max;
+        uint32_t resyncs;
+    };
+
     // Счётчик кадров и тайминг
+    // The period is 1000 / fps ms exactly: whole ms plus a remainder that is
+    // carried in units of 1 / fps ms, so 45 fps runs at 45 and not 45.45.
     uint32_t frame_count_ = 0;
-    uint32_t frame_duration_ms_ = 33;
-    uint32_t last_frame_ms_ = 0;
+    uint8_t frame_rate_ = 30;
+    uint32_t frame_period_ms_ = 33;
+    uint32_t frame_period_rem_ = 10;
+    uint32_t frame_rem_acc_ = 0;
+    uint32_t next_frame_ms_ = 0;
+    FrameTimingStats frame_stats_ = {};
 
     // Курсор и текст
     int16_t cursor_x_ = 0;
@@ -130,6 +145,9 @@ public:
 
     void setFrameRate(uint8_t fps);
     bool nextFrame();
+    uint32_t nextFrameDeadline() const;
+    void getFrameTimingStats(FrameTimingStats& out) const;
+    void resetFrameTimingStats();
     bool everyXFrames(uint8_t n) const;
 
     void pollButtons();
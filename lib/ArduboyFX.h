@@ -8,6 +8,8 @@
 
 #include <furi.h>
 #include <storage/storage.h>
+#include "include/FxTrace.h"
+#include "include/FxPack.h"
 using uint24_t = uint32_t;
 
 struct JedecID {
@@ -85,6 +87,78 @@ public:
     static uint32_t readIndexedUInt24(uint32_t address, uint8_t index);
     static uint32_t readIndexedUInt32(uint32_t address, uint8_t index);
 
+    // Cursor over the data domain that reads straight out of the cached page
+    // it is on: the fast paths below only compare two pointers and the cache
+    // epoch, refill_() runs at page boundaries or after the page was evicted.
+    // Values are big-endian like readPending*(). A Reader does not touch the
+    // seekData() stream, so both can be used at once.
+    class Reader {
+    public:
+        Reader() = default;
+        explicit Reader(uint24_t address) {
+            seek(address);
+        }
+
+        void seek(uint24_t address);
+        void seekArray(uint24_t address, uint8_t index, uint8_t offset, uint8_t elementSize);
+        void skip(uint32_t length);
+
+        uint8_t readUInt8() {
+            if(ptr_ != end_ && epoch_ == cache_epoch_) return *ptr_++;
+            return refillUInt8_();
+        }
+
+        uint16_t readUInt16() {
+            if(end_ - ptr_ >= 2 && epoch_ == cache_epoch_) {
+                const uint16_t v = (uint16_t)((ptr_[0] << 8) | ptr_[1]);
+                ptr_ += 2;
+                return v;
+            }
+            const uint16_t hi = readUInt8();
+            return (uint16_t)((hi << 8) | readUInt8());
+        }
+
+        uint32_t readUInt24() {
+            if(end_ - ptr_ >= 3 && epoch_ == cache_epoch_) {
+                const uint32_t v = ((uint32_t)ptr_[0] << 16) | ((uint32_t)ptr_[1] << 8) | ptr_[2];
+                ptr_ += 3;
+                return v;
+            }
+            const uint32_t hi = readUInt8();
+            return (hi << 16) | readUInt16();
+        }
+
+        uint32_t readUInt32() {
+            if(end_ - ptr_ >= 4 && epoch_ == cache_epoch_) {
+                const uint32_t v = ((uint32_t)ptr_[0] << 24) | ((uint32_t)ptr_[1] << 16) |
+                                   ((uint32_t)ptr_[2] << 8) | ptr_[3];
+                ptr_ += 4;
+                return v;
+            }
+            const uint32_t hi = readUInt16();
+            return (hi << 16) | readUInt16();
+        }
+
+        void readBytes(uint8_t* buffer, size_t length);
+
+        // Up to `length` contiguous bytes at the cursor, valid until the next
+        // FX call that may load a page. `length` is cut to what the current
+        // page holds, and is 0 if the page cannot be loaded.
+        const uint8_t* span(size_t& length);
+
+    private:
+        const uint8_t* ptr_ = nullptr;
+        const uint8_t* end_ = nullptr;
+        uint32_t end_abs_ = 0; // absolute offset that end_ maps to
+        uint32_t epoch_ = 0;
+
+        uint32_t position_() const {
+            return end_abs_ - (uint32_t)(end_ - ptr_);
+        }
+        bool refill_();
+        uint8_t refillUInt8_();
+    };
+
     static void commit();
     static void eraseSaveBlock(uint16_t block);
     static uint8_t loadGameState(uint8_t* gameState, size_t size);
@@ -98,6 +172,19 @@ public:
         saveGameState((const uint8_t*)&gameState, sizeof(T));
     }
 
+    // Variable-length states: copies the latest save of at most `capacity`
+    // bytes and returns its size, or 0 if there is none that fits.
+    static size_t loadGameStateUpTo(uint8_t* gameState, size_t capacity);
+
+    // Non-blocking save: the state is copied and written by a worker thread
+    // into the older of two checksummed slots. loadGameState() returns the
+    // latest state handed in here, falling back to the save block log.
+    static bool saveGameStateAsync(const uint8_t* gameState, size_t size);
+    template <typename T>
+    static bool saveGameStateAsync(const T& gameState) {
+        return saveGameStateAsync((const uint8_t*)&gameState, sizeof(T));
+    }
+
     static void setFrame(uint24_t frame_addr, uint8_t frame_count);
     static bool drawFrame();
     static bool drawFrame(uint24_t frame_addr);
@@ -107,17 +194,86 @@ public:
     static void disableOLED();
 
     static void warmUpData(uint32_t address, size_t length);
+
+    enum HintPriority : uint8_t {
+        hintLow = 0,
+        hintNormal = 1,
+        hintHigh = 2,
+    };
+    static void hintRange(uint24_t address, uint32_t length, uint8_t priority);
+    static void hintBitmapFrame(uint24_t bitmap_addr, uint8_t frame, uint8_t mode, uint8_t priority);
     static void waitWhileBusy();
     static void writeSavePage(uint16_t page, const uint8_t* buffer);
 
+    static void setTraceTag(uint8_t tag) {
+#ifdef ARDULIB_FX_TRACE
+        trace_tag_ = tag;
+#else
+        (void)tag;
+#endif
+    }
+
+#ifdef ARDULIB_FX_PREFETCH_MANUAL
+    // Host builds: no worker thread is started. Each call services the
+    // oldest queued prefetch on the calling thread and returns false once
+    // the ring is empty; the next page lookup retires the result. The
+    // embedding program supplies the furi/storage symbols and decides when
+    // to step, so reads land at chosen points between lookups.
+    static bool prefetchStep();
+#endif
+
+    struct BitmapMetaStats {
+        uint32_t hits;
+        uint32_t misses;
+    };
+    static void getBitmapMetaStats(BitmapMetaStats& stats);
+    static void resetBitmapMetaStats();
+
+    // Deferred drawing. After beginDrawList(), drawBitmap() records the call
+    // in the current layer instead of drawing it; flushDrawList(), or
+    // display() at the latest, draws the list. Layers are drawn lowest
+    // first, and within a layer the draws are ordered by frame data address
+    // so a page is read from once rather than on and off. A draw only moves
+    // ahead of draws it does not overlap, so a layer looks the same as if
+    // drawn in call order.
+    static void beginDrawList();
+    static void setDrawLayer(uint8_t layer);
+    static void flushDrawList();
+
+    // A page change is a draw whose first row lies in another page than the
+    // previous draw's; "recorded" counts them in call order, "drawn" in the
+    // order the list was drawn. `page_misses` are cache misses while drawing.
+    // The last_ fields cover the list since the latest beginDrawList().
+    struct DrawListStats {
+        uint32_t flushes;
+        uint32_t draws;
+        uint32_t batches;
+        uint32_t changes_recorded;
+        uint32_t changes_drawn;
+        uint32_t page_misses;
+        uint16_t last_changes_saved;
+        uint16_t last_page_misses;
+    };
+    static void getDrawListStats(DrawListStats& stats);
+    static void resetDrawListStats();
+
 
 private:
     enum class Domain : uint8_t { Data, Save };
 
     static constexpr uint16_t kSaveBlockSize = 4096;
+    static constexpr uint8_t kNoSlot = 0xFF;
+    static constexpr uint8_t kMaxCachePages = 254;
     static constexpr size_t kPathMax = 128;
     static constexpr const char* kDataPath = APP_ASSETS_PATH("fxdata.bin");
     static constexpr const char* kSavePath = APP_DATA_PATH("fxsave.bin");
+    static constexpr const char* kSaveSlotsPath = APP_DATA_PATH("fxslots.bin");
+    static constexpr uint16_t kSaveSlotSize = 2048;
+    static constexpr uint8_t kSaveSlotHeader = 16;
+#ifdef ARDULIB_FX_TRACE
+    static constexpr const char* kTracePath = APP_DATA_PATH("fxtrace.bin");
+    static constexpr uint16_t kTraceBufRecords = 64;
+#endif
 
     static Storage* storage_;
     static File*    data_;
@@ -134,9 +290,13 @@ private:
     static uint8_t* cache_mem_;
     static uint32_t* cache_base_;
     static uint16_t* cache_len_;
-    static uint32_t* cache_age_;
     static uint8_t* cache_valid_;
-    static uint32_t cache_age_ctr_;
+    static uint8_t* cache_prev_;
+    static uint8_t* cache_next_;
+    static uint8_t  lru_head_;
+    static uint8_t  lru_tail_;
+    static uint8_t* page_hash_;
+    static uint16_t page_hash_mask_;
     static uint8_t  last_hit_;
     static uint32_t last_base_;
     static uint8_t  seq_score_;
@@ -146,10 +306,75 @@ private:
     static uint32_t stream_abs_;
     static uint8_t* stream_ptr_;
     static bool     stream_valid_;
+    // Bumped whenever a cache slot is given to another page, so a Reader
+    // notices its span went stale.
+    static uint32_t cache_epoch_;
+
+    // Packed container (lib/include/FxPack.h); pack_page_size_ == 0 for a
+    // plain fxdata.bin.
+    static uint16_t pack_page_size_;
+    static uint32_t pack_raw_size_;
+    static uint32_t pack_pages_;
+    static uint32_t* pack_index_;
+    static uint8_t* pack_buf_;
+    static uint8_t* prefetch_pack_buf_;
+
+    // RAM copy of the save block, loaded by openSave_(). Writes land here and
+    // widen one dirty span [save_dirty_lo_, save_dirty_hi_) that commit()
+    // writes back in a single call.
+    static uint8_t  save_mem_[kSaveBlockSize];
+    static uint16_t save_dirty_lo_;
+    static uint16_t save_dirty_hi_;
+
+    // Async save slots. The game thread fills save_stage_[save_front_] and
+    // swaps it with save_middle_; the writer swaps save_middle_ with its own
+    // save_back_ (triple buffering, kSaveStageNew marks an unread middle).
+    // States vary in length: save_stage_size_ is the capacity of each
+    // buffer, save_stage_len_ the length of the state it holds.
+    static constexpr uint8_t kSaveStageNew = 0x80;
+    static constexpr uint32_t kSaveWakeFlag = 1u << 0;
+    static uint8_t* save_stage_;
+    static uint8_t* save_latest_;
+    static uint16_t save_stage_size_;
+    static uint16_t save_stage_len_[3];
+    static uint16_t save_latest_len_;
+    static uint32_t save_stage_seq_[3];
+    static uint8_t  save_front_;
+    static uint8_t  save_middle_;
+    static uint8_t  save_back_;
+    static uint32_t save_seq_;
+    static uint8_t  save_disk_slot_;
+    static bool     save_running_;
+    static FuriThread* save_thread_;
+    static File*    save_slots_file_;
 
     static uint32_t data_file_pos_;
     static bool     data_file_pos_valid_;
 
+    struct PrefetchReq {
+        uint32_t base;
+        uint8_t slot;
+    };
+    static constexpr uint8_t kPrefetchRingSize = 16;
+    static constexpr uint32_t kPrefetchWakeFlag = 1u << 0;
+    static PrefetchReq prefetch_ring_[kPrefetchRingSize];
+    static uint8_t  prefetch_head_;
+    static uint8_t  prefetch_tail_;
+    static uint8_t  prefetch_retire_;
+    static bool     prefetch_running_;
+    static FuriThread* prefetch_thread_;
+    static File*    prefetch_file_;
+
+#ifdef ARDULIB_FX_TRACE
+    static File*    trace_;
+    static uint8_t  trace_buf_[kTraceBufRecords * FX_TRACE_RECORD_SIZE];
+    static uint16_t trace_count_;
+    static uint16_t trace_frame_;
+    static uint8_t  trace_tag_;
+    static bool     trace_stream_open_;
+    static uint32_t trace_stream_start_;
+#endif
+
     static bool    pending_valid_;
     static uint8_t pending_byte_;
     static uint8_t data_read_buf_[256];
@@ -162,19 +387,56 @@ private:
     static uint8_t frame_count_;
     static uint8_t frame_idx_;
 
+    // One visible bitmap row, masked: WIDTH columns of image + mask bytes.
+    static constexpr size_t kDrawScratchSize = 2u * 128u;
+    static uint8_t draw_scratch_[kDrawScratchSize];
+
     struct BitmapMetaCacheEntry {
         uint24_t addr;
+        uint32_t frame_stride;
+        uint32_t masked_stride;
         uint16_t w;
         uint16_t h;
-        uint16_t pages;
+        uint16_t rows;
         uint8_t valid;
     };
-    static constexpr uint8_t kBitmapMetaCacheSize = 16;
+    // One room draws ~20 distinct tile/sprite sheets; 4-way probing keeps
+    // the lookup bounded while leaving headroom for HUD and menu assets.
+    static constexpr uint8_t kBitmapMetaCacheSize = 32;
+    static constexpr uint8_t kBitmapMetaCacheWays = 4;
     static BitmapMetaCacheEntry bitmap_meta_cache_[kBitmapMetaCacheSize];
     static uint8_t bitmap_meta_rr_;
+    static BitmapMetaStats bitmap_meta_stats_;
+
+    struct DrawCommand {
+        uint24_t addr;
+        uint32_t data;
+        int16_t x;
+        int16_t y;
+        uint16_t w;
+        uint16_t h;
+        uint8_t frame;
+        uint8_t mode;
+        uint8_t layer;
+    };
+    // render() records 30-odd on-screen draws a frame; a full list is drawn
+    // early and recording carries on into an empty one.
+    static constexpr uint8_t kDrawListSize = 96;
+    static DrawCommand draw_list_[kDrawListSize];
+    // Earlier overlapping draws each draw still waits for, kDrawDone once drawn.
+    static constexpr uint8_t kDrawDone = 0xFF;
+    static uint8_t draw_waits_[kDrawListSize];
+    static uint8_t draw_list_len_;
+    static uint8_t draw_layer_;
+    static bool draw_list_active_;
+    static DrawListStats draw_list_stats_;
+    static uint32_t page_misses_;
 
     static bool ensureStorage_();
     static bool openData_();
+    static bool packOpen_();
+    static void packClose_();
+    static size_t dataReadPage_(File* f, uint32_t base, uint8_t* dst, uint8_t* scratch);
     static bool openSave_();
 
     static bool fileFill_(File* f, uint8_t value, size_t len);
@@ -187,10 +449,25 @@ private:
     static uint32_t alignDown_(uint32_t v, uint32_t a);
     static uint32_t alignUp_(uint32_t v, uint32_t a);
     static void streamReset_();
+    static uint16_t pageHashHome_(uint32_t base);
+    static uint8_t pageHashFind_(uint32_t base);
+    static void pageHashInsert_(uint32_t base, uint8_t slot);
+    static void pageHashErase_(uint32_t base);
+    static void lruUnlink_(uint8_t i);
+    static void lruPushFront_(uint8_t i);
+    static void lruPushBack_(uint8_t i);
+    static void lruTouch_(uint8_t i);
+    static void lruDemote_(uint8_t i);
     static bool dataPageHas_(uint32_t base);
     static uint8_t dataPickVictim_();
     static bool dataLoadPage_(uint32_t base, uint8_t page_i);
     static void dataMaybePrefetch_(uint32_t base);
+    static bool prefetchStart_();
+    static void prefetchStop_();
+    static bool prefetchRequest_(uint32_t base);
+    static void prefetchCollect_();
+    static bool prefetchServiceOne_();
+    static int32_t prefetchThread_(void* context);
     static bool dataEnsurePageIndex_(uint32_t abs_off, uint8_t* out_index);
     static bool streamEnsureAbs_(uint32_t abs_off);
     static bool streamEnsureAbsFast_(uint32_t abs_off);
@@ -198,14 +475,37 @@ private:
 
     static uint32_t absDataOffset_(uint32_t address);
 
+#ifdef ARDULIB_FX_TRACE
+    static void traceOpen_();
+    static void traceClose_();
+    static void traceFlush_();
+    static void traceRecord_(uint32_t abs, uint32_t length, uint8_t kind);
+    static void traceStreamEnd_();
+#endif
+
     static void primePendingData_();
     static void primePendingSave_();
 
+    static bool saveStageAlloc_();
+    static void saveStageFree_();
+    static bool saveSlotRead_(uint8_t slot, uint32_t* seq);
+    static bool saveSlotWrite_(uint8_t slot, uint32_t seq, const uint8_t* payload, uint16_t size);
+    static void saveSlotsScan_();
+    static bool saveWriterStart_();
+    static void saveWriterStop_();
+    static void saveWriterDrain_();
+    static int32_t saveWriterThread_(void* context);
+    static uint8_t saveByteAt_(uint32_t off);
+    static void saveMarkDirty_(uint32_t off, size_t len);
     static uint16_t readSaveU16BE_(uint16_t off);
     static void writeSaveU16BE_(uint16_t off, uint16_t v);
     static bool readDataAt_(uint32_t address, uint8_t* buffer, size_t length);
     static const uint8_t* dataPtrAt_(uint32_t address, size_t length);
-    static bool getBitmapMeta_(uint24_t bitmap_addr, uint16_t* out_w, uint16_t* out_h, uint16_t* out_pages);
+    static const BitmapMetaCacheEntry* getBitmapMeta_(uint24_t bitmap_addr);
+    static void bitmapMetaReset_();
+    static void drawBitmapMeta_(const BitmapMetaCacheEntry* meta, int16_t x, int16_t y, uint24_t bitmap_addr, uint8_t frame, uint8_t mode);
+    static bool drawListOverlap_(const DrawCommand& a, const DrawCommand& b);
+    static void drawListRun_();
     static void dataReadBufInvalidate_();
     static size_t dataReadSpanAt_(uint32_t abs, uint8_t* out, size_t len);
     static bool dataReadByteAt_(uint32_t abs, uint8_t* out);
@@ -65,9 +65,20 @@ static inline uint16_t ardulib_tone_strip_volume(uint16_t freq_word) {
     return (uint16_t)(freq_word & (uint16_t)~TONE_HIGH_VOLUME);
 }
 
+// Note-onset timing of the sound thread. An onset is counted when a note
+// follows another on a deadline; the first note of a pattern is not.
+typedef struct {
+    uint32_t notes;
+    uint32_t late_ms_total;
+    uint32_t late_ms_max;
+    uint32_t wakeups;
+} ArduboyToneTimingStats;
+
 void ardulib_tone_init();
 void ardulib_tone_stop();
 void ardulib_tone_deinit();
+void ardulib_tone_get_stats(ArduboyToneTimingStats* out);
+void ardulib_tone_reset_stats();
 
 class ArduboyTones {
 public:
@@ -78,6 +89,9 @@ public:
     static bool playing();
     void tones(const uint16_t* pattern);
     void tonesInRAM(uint16_t* pattern);
+    // `pattern` lives in a producer slot whose generation is `*stamp`, see
+    // ArduboyAudioState.h.
+    void tonesInSlot(const uint16_t* pattern, const volatile uint32_t* stamp);
     void noTone();
     void tone(uint16_t frequency, uint16_t duration_ms);
     void tone(uint16_t freq, uint16_t dur_ms, uint16_t freq2, uint16_t dur2_ms);
@@ -85,6 +99,8 @@ public:
     static void nextTone() {}
 
 private:
+    static void request_(const ArduboyToneSoundRequest& req);
+
     static inline uint16_t ms_to_ticks16_(uint16_t ms) {
         if(ms == 0) return 0;
         uint32_t ticks = (ms * kArduboyToneToneTickHz + 500u) / 1000u;
@@ -113,6 +129,7 @@ public:
     static bool playing() { return false; }
     void tones(const uint16_t* /*pattern*/) {}
     void tonesInRAM(uint16_t* /*pattern*/) {}
+    void tonesInSlot(const uint16_t* /*pattern*/, const volatile uint32_t* /*stamp*/) {}
     void noTone() {}
     void tone(uint16_t /*frequency*/, uint16_t /*duration_ms*/) {}
     void tone(uint16_t /*freq*/, uint16_t /*dur_ms*/, uint16_t /*freq2*/, uint16_t /*dur2_ms*/) {
@@ -7,13 +7,24 @@
 #endif
 
 #ifdef ARDULIB_USE_TONES
+/*
+ * A pattern is either fixed (generation 0) or lives in a producer's slot.
+ * A slot carries a stamp, which holds the generation of its contents, or 0
+ * while it is being rewritten. The sound thread publishes the generation it
+ * is playing in g_arduboy_tones_active_gen. A producer may only rewrite a
+ * slot whose stamp is not the active generation. The sound thread skips a
+ * request whose slot has been rewritten since it was queued.
+ */
 typedef struct {
     const uint16_t* pattern;
+    uint32_t generation;
+    const volatile uint32_t* stamp;
 } ArduboyToneSoundRequest;
 
 extern FuriMessageQueue* g_arduboy_sound_queue;
 extern FuriThread* g_arduboy_sound_thread;
 extern volatile bool g_arduboy_sound_thread_running;
+extern volatile uint32_t g_arduboy_tones_active_gen;
 #endif
 
 extern volatile bool g_arduboy_audio_enabled;
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <stdint.h>
+
+/*
+ * Row kernels behind FX::drawBitmap (tools/fxblitbench times them on a host).
+ *
+ * One call blends one 8-pixel source row into the screen: `dst0` is the
+ * display row the bitmap starts in, `dst1` the one below when y is not a
+ * multiple of 8. Either may be null when that row is off screen. Columns are
+ * already clipped, so the kernels never bounds-check.
+ *
+ * Mode bits follow FX::DrawMode. Kernels are instantiated per mode so the
+ * per-column tests fold away; FX_BLIT_MODE_RUNTIME builds the fallback that
+ * reads the bits from its `mode` argument instead.
+ */
+
+#define FX_BLIT_WHITE_BLACK   (1u << 0)
+#define FX_BLIT_INVERT        (1u << 1)
+#define FX_BLIT_BLACK         (1u << 2)
+#define FX_BLIT_REVERSE_BLACK (1u << 3)
+#define FX_BLIT_MASKED        (1u << 4)
+#define FX_BLIT_FLIP          (1u << 5)
+#define FX_BLIT_MODE_BITS     0x3Fu
+#define FX_BLIT_MODE_RUNTIME  0xFFu
+
+struct FxBlitRow {
+    const uint8_t* src; // image bytes, interleaved with mask bytes when masked
+    uint8_t* dst0;
+    uint8_t* dst1;
+    uint8_t count; // columns to draw
+    uint8_t rowmask; // bits of this source row inside the image
+    uint8_t shift; // y & 7
+};
+
+typedef void (*FxBlitRowFn)(const FxBlitRow& row, uint8_t mode);
+
+static inline uint8_t fx_blit_blend(uint8_t display, uint8_t pixels, uint8_t mask, bool invert) {
+    if(!invert) pixels ^= display;
+    return (uint8_t)((pixels & mask) ^ display);
+}
+
+template <uint8_t Mode, bool Shifted>
+static void fx_blit_row(const FxBlitRow& row, uint8_t runtime_mode) {
+    const uint8_t mode = (Mode == FX_BLIT_MODE_RUNTIME) ? runtime_mode : Mode;
+    const bool masked = (mode & FX_BLIT_MASKED) != 0;
+    const bool white_black = (mode & FX_BLIT_WHITE_BLACK) != 0;
+    const bool black = (mode & FX_BLIT_BLACK) != 0;
+    const bool reverse_black = (mode & FX_BLIT_REVERSE_BLACK) != 0;
+    const bool invert = (mode & FX_BLIT_INVERT) != 0;
+    const bool flip = (mode & FX_BLIT_FLIP) != 0;
+
+    const uint8_t* s = row.src;
+    const int8_t step = flip ? -1 : 1;
+    const int16_t first = flip ? (int16_t)(row.count - 1) : 0;
+    uint8_t* d0 = row.dst0 ? row.dst0 + first : nullptr;
+    uint8_t* d1 = Shifted && row.dst1 ? row.dst1 + first : nullptr;
+
+    for(uint8_t c = 0; c < row.count; c++) {
+        uint8_t bitmapbyte = *s++;
+        if(reverse_black) bitmapbyte ^= row.rowmask;
+
+        uint8_t maskbyte = row.rowmask;
+        if(white_black) maskbyte = bitmapbyte;
+        if(black) bitmapbyte = 0;
+        if(masked) {
+            const uint8_t m = *s++;
+            if(!white_black) maskbyte = m;
+        }
+
+        if(Shifted) {
+            const uint16_t bitmap = (uint16_t)((uint16_t)bitmapbyte << row.shift);
+            const uint16_t mask = (uint16_t)((uint16_t)maskbyte << row.shift);
+            if(d0) {
+                *d0 = fx_blit_blend(*d0, (uint8_t)bitmap, (uint8_t)mask, invert);
+                d0 += step;
+            }
+            if(d1) {
+                *d1 = fx_blit_blend(*d1, (uint8_t)(bitmap >> 8), (uint8_t)(mask >> 8), invert);
+                d1 += step;
+            }
+        } else {
+            *d0 = fx_blit_blend(*d0, bitmapbyte, maskbyte, invert);
+            d0 += step;
+        }
+    }
+}
+
+// The game draws almost everything as dbmNormal (tiles) or dbmMasked
+// (sprites); those get dedicated kernels, anything else the runtime one.
+static inline FxBlitRowFn fx_blit_pick(uint8_t mode, bool shifted) {
+    switch(mode & FX_BLIT_MODE_BITS) {
+    case 0:
+        return shifted ? fx_blit_row<0, true> : fx_blit_row<0, false>;
+    case FX_BLIT_MASKED:
+        return shifted ? fx_blit_row<FX_BLIT_MASKED, true> : fx_blit_row<FX_BLIT_MASKED, false>;
+    default:
+        return shifted ? fx_blit_row<FX_BLIT_MODE_RUNTIME, true> :
+                         fx_blit_row<FX_BLIT_MODE_RUNTIME, false>;
+    }
+}
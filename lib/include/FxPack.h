@@ -0,0 +1,82 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/*
+ * Paged, compressed fxdata container (tools/fxpack).
+ *
+ * File layout, little-endian:
+ *   header : "FXPK" version:u8 codec:u8 page_size:u16 raw_size:u32 page_count:u32
+ *   index  : offset:u32 x (page_count + 1), absolute file offsets
+ *   pages  : page i is stored in [index[i], index[i + 1])
+ *
+ * Every page but the last holds page_size bytes of fxdata.bin once decoded.
+ * A page whose stored size equals its decoded size is kept as-is, so pages
+ * that do not compress cost nothing to load.
+ *
+ * The codec is the LZ4 block format: token (literal run:4, match length - 4:4),
+ * 255-continued lengths, literals, 16-bit match offset. Matches never reach
+ * outside the page, so every page decodes on its own.
+ */
+
+#define FX_PACK_MAGIC       "FXPK"
+#define FX_PACK_VERSION     1
+#define FX_PACK_HEADER_SIZE 16
+#define FX_PACK_CODEC_LZ4   1
+
+static inline uint32_t fx_pack_le32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// Decodes one page. Returns the number of bytes written, or 0 if the input is
+// malformed or does not fit in dst_cap.
+static inline size_t fx_pack_decode(const uint8_t* src, size_t src_len, uint8_t* dst, size_t dst_cap) {
+    const uint8_t* ip = src;
+    const uint8_t* const iend = src + src_len;
+    uint8_t* op = dst;
+    uint8_t* const oend = dst + dst_cap;
+
+    while(ip < iend) {
+        const uint8_t token = *ip++;
+
+        size_t lit = token >> 4;
+        if(lit == 15) {
+            uint8_t b;
+            do {
+                if(ip >= iend) return 0;
+                b = *ip++;
+                lit += b;
+            } while(b == 255);
+        }
+        if((size_t)(iend - ip) < lit || (size_t)(oend - op) < lit) return 0;
+        memcpy(op, ip, lit);
+        ip += lit;
+        op += lit;
+        if(ip == iend) break; // last sequence carries literals only
+
+        if(iend - ip < 2) return 0;
+        const size_t off = (size_t)ip[0] | ((size_t)ip[1] << 8);
+        ip += 2;
+        if(off == 0 || off > (size_t)(op - dst)) return 0;
+
+        size_t len = token & 15u;
+        if(len == 15) {
+            uint8_t b;
+            do {
+                if(ip >= iend) return 0;
+                b = *ip++;
+                len += b;
+            } while(b == 255);
+        }
+        len += 4;
+        if((size_t)(oend - op) < len) return 0;
+
+        // Byte copy: the match may overlap the bytes it produces.
+        const uint8_t* m = op - off;
+        while(len--)
+            *op++ = *m++;
+    }
+    return (size_t)(op - dst);
+}
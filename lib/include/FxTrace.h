@@ -0,0 +1,36 @@
+#pragma once
+
+#include <stdint.h>
+
+/*
+ * FX access trace (ARDULIB_FX_TRACE).
+ *
+ * File layout, little-endian:
+ *   header : "FXTR" version:u8 record_size:u8 page_size:u16
+ *   record : addr:u24 len:u16 frame:u16 kind:u8 tag:u8
+ *
+ * One record per logical read that reaches the page cache. `frame` is the
+ * FX::display() count and wraps at 16 bits; `tag` is whatever the game last
+ * passed to FX::setTraceTag().
+ */
+
+#define FX_TRACE_MAGIC       "FXTR"
+#define FX_TRACE_VERSION     1
+#define FX_TRACE_HEADER_SIZE 8
+#define FX_TRACE_RECORD_SIZE 9
+
+typedef enum {
+    FxTraceKindStream = 0, // seekData() .. readEnd()
+    FxTraceKindRead = 1, // readDataAt_() copy, e.g. bitmap rows and headers
+    FxTraceKindPtr = 2, // dataPtrAt_() zero-copy span
+    FxTraceKindSpan = 3, // FX::Reader page span (length is what the page had left)
+} FxTraceKind;
+
+typedef enum {
+    FxTraceTagNone = 0,
+    FxTraceTagLogic = 1,
+    FxTraceTagLevel = 2,
+    FxTraceTagRender = 3,
+    FxTraceTagMenu = 4,
+    FxTraceTagSound = 5,
+} FxTraceTag;
@@ -16,5 +16,15 @@ void arduboy_screen_invert(bool invert);
 void arduboy_screen_invert_toggle(void);
 void rt_display(bool clear);
 
+// Frames passed to the GUI and frames dropped by rt_display() because they
+// matched the one already on screen.
+typedef struct {
+    uint32_t committed;
+    uint32_t skipped;
+} ArduboyDisplayStats;
+
+void arduboy_display_stats(ArduboyDisplayStats* out);
+void arduboy_display_stats_reset(void);
+
 void setup(void);
 void loop(void);
@@ -62,7 +62,8 @@ void Arduboy2Base::begin(
     exit_requested_ = exit_requested;
     external_timing_ = false;
     frame_count_ = 0;
-    last_frame_ms_ = 0;
+    frame_rem_acc_ = 0;
+    next_frame_ms_ = millis();
     resetInputState();
     audio.begin();
 }
@@ -138,8 +139,11 @@ void Arduboy2Base::bootLogoSpritesSelfMasked() {
 
 void Arduboy2Base::setFrameRate(uint8_t fps) {
     if(fps == 0) fps = 30;
-    uint32_t d = 1000u / fps;
-    frame_duration_ms_ = d ? d : 1u;
+    if(fps > 250) fps = 250;
+    frame_rate_ = fps;
+    frame_period_ms_ = 1000u / fps;
+    frame_period_rem_ = 1000u % fps;
+    frame_rem_acc_ = 0;
 }
 
 bool Arduboy2Base::nextFrame() {
@@ -148,12 +152,43 @@ bool Arduboy2Base::nextFrame() {
         return true;
     }
     const uint32_t now = millis();
-    if((uint32_t)(now - last_frame_ms_) < frame_duration_ms_) return false;
-    last_frame_ms_ = now;
+    const int32_t late = (int32_t)(now - next_frame_ms_);
+    if(late < 0) return false;
+
+    if((uint32_t)late >= frame_period_ms_) {
+        // Too far behind to catch up without a burst of frames.
+        next_frame_ms_ = now;
+        frame_rem_acc_ = 0;
+        frame_stats_.resyncs++;
+    } else {
+        frame_stats_.frames++;
+        frame_stats_.late_ms_total += (uint32_t)late;
+        if((uint32_t)late > frame_stats_.late_ms_max) frame_stats_.late_ms_max = (uint32_t)late;
+    }
+
+    next_frame_ms_ += frame_period_ms_;
+    frame_rem_acc_ += frame_period_rem_;
+    if(frame_rem_acc_ >= frame_rate_) {
+        frame_rem_acc_ -= frame_rate_;
+        next_frame_ms_++;
+    }
+
     frame_count_++;
     return true;
 }
 
+uint32_t Arduboy2Base::nextFrameDeadline() const {
+    return next_frame_ms_;
+}
+
+void Arduboy2Base::getFrameTimingStats(FrameTimingStats& out) const {
+    out = frame_stats_;
+}
+
+void Arduboy2Base::resetFrameTimingStats() {
+    frame_stats_ = {};
+}
+
 bool Arduboy2Base::everyXFrames(uint8_t n) const {
     if(n == 0) return false;
     return (frame_count_ % n) == 0;
@@ -661,7 +696,8 @@ void Arduboy2Base::setRGBled(uint8_t color, uint8_t val) {
 }
 
 void Arduboy2Base::expectLoadDelay() {
-    last_frame_ms_ = millis();
+    next_frame_ms_ = millis() + frame_period_ms_;
+    frame_rem_acc_ = 0;
 }
 
 uint32_t Arduboy2Base::frameCount() const {
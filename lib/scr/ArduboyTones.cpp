@@ -1,123 +1,139 @@
 #include "../ArduboyTones.h"
 
 #ifdef ARDULIB_USE_TONES
-static int32_t ardulib_tone_sound_thread_fn(void* /*ctx*/) {
-    ArduboyToneSoundRequest req;
-    const uint16_t* current_pattern = NULL;
+// Makes `req` the active pattern (see ArduboyAudioState.h). False if its slot
+// was rewritten after it was queued; the new contents are queued behind it.
+static bool ardulib_tone_accept(const ArduboyToneSoundRequest* req) {
+    __atomic_store_n(&g_arduboy_tones_active_gen, req->generation, __ATOMIC_SEQ_CST);
+    if(req->generation == 0) return true;
+    return __atomic_load_n(req->stamp, __ATOMIC_SEQ_CST) == req->generation;
+}
 
-    while(g_arduboy_sound_thread_running) {
-        if(furi_message_queue_get(g_arduboy_sound_queue, &req, 50) != FuriStatusOk) {
-            continue;
-        }
+static void ardulib_tone_release_active() {
+    __atomic_store_n(&g_arduboy_tones_active_gen, 0u, __ATOMIC_RELEASE);
+}
 
-        if(!req.pattern) {
-            current_pattern = NULL;
-            if(furi_hal_speaker_is_mine()) furi_hal_speaker_stop();
-            g_arduboy_tones_playing = false;
-            continue;
-        }
+// Longest wait with nothing scheduled; bounds how late a cleared
+// g_arduboy_sound_thread_running is noticed when no stop request follows.
+static constexpr uint32_t kArduboyToneIdleWaitMs = 50;
 
-        current_pattern = req.pattern;
+static ArduboyToneTimingStats g_arduboy_tone_stats;
 
-        if(!g_arduboy_audio_enabled) {
-            g_arduboy_tones_playing = false;
-            continue;
-        }
+// Written by the sound thread only; relaxed atomics keep readers tear-free.
+static void ardulib_tone_count_onset(uint32_t scheduled, uint32_t now) {
+    const int32_t late = (int32_t)(now - scheduled);
+    const uint32_t late_ms = late > 0 ? (uint32_t)late : 0;
+    __atomic_add_fetch(&g_arduboy_tone_stats.notes, 1u, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&g_arduboy_tone_stats.late_ms_total, late_ms, __ATOMIC_RELAXED);
+    if(late_ms > __atomic_load_n(&g_arduboy_tone_stats.late_ms_max, __ATOMIC_RELAXED)) {
+        __atomic_store_n(&g_arduboy_tone_stats.late_ms_max, late_ms, __ATOMIC_RELAXED);
+    }
+}
 
-        if(!furi_hal_speaker_acquire(50)) {
-            g_arduboy_tones_playing = false;
+// Starts the note at `p` and moves `deadline` to its end. `holding` is set
+// for a note with no duration, which lasts until the next request. False at
+// the end of the pattern.
+static bool ardulib_tone_start_note(
+    const uint16_t* start,
+    const uint16_t*& p,
+    uint32_t& deadline,
+    bool& holding) {
+    bool repeated = false;
+
+    for(;;) {
+        const uint16_t freq_word = *p++;
+
+        if(freq_word == TONES_END) return false;
+
+        if(freq_word == TONES_REPEAT) {
+            // A second repeat without a note in between would spin forever.
+            if(repeated) return false;
+            repeated = true;
+            p = start;
             continue;
         }
 
-        g_arduboy_tones_playing = true;
-
-        const uint16_t* start = current_pattern;
-        const uint16_t* p = current_pattern;
-        uint32_t timeline_ms = furi_get_tick();
-
-        while(g_arduboy_sound_thread_running && g_arduboy_audio_enabled) {
-            ArduboyToneSoundRequest new_req;
-            if(furi_message_queue_get(g_arduboy_sound_queue, &new_req, 0) == FuriStatusOk) {
-                if(!new_req.pattern) {
-                    g_arduboy_tones_playing = false;
-                    break;
-                } else {
-                    current_pattern = new_req.pattern;
-                    start = current_pattern;
-                    p = current_pattern;
-                }
-            }
+        const uint16_t dur_ticks = *p++;
+        const uint16_t freq = ardulib_tone_strip_volume(freq_word);
 
-            uint16_t freq_word = *p++;
+        if(freq == 0) {
+            furi_hal_speaker_stop();
+        } else {
+            furi_hal_speaker_start((float)freq, ardulib_tone_volume_for(freq_word));
+        }
 
-            if(freq_word == TONES_END) {
-                g_arduboy_tones_playing = false;
-                break;
-            }
+        holding = (dur_ticks == 0);
+        if(!holding) {
+            const uint32_t dur_ms = ardulib_tone_ticks_to_ms(dur_ticks);
+            deadline += dur_ms ? dur_ms : 1;
+        }
+        return true;
+    }
+}
 
-            if(freq_word == TONES_REPEAT) {
-                p = start;
-                continue;
-            }
+// Each note ends at an absolute deadline on a timeline anchored where its
+// pattern started, so lateness never accumulates. Between notes the thread
+// blocks on the queue for exactly the time left, which lets a new request
+// cut in at once. All timing goes through furi_get_tick() and the queue
+// timeout, so a host build can drive the thread from a virtual clock.
+static int32_t ardulib_tone_sound_thread_fn(void* /*ctx*/) {
+    ArduboyToneSoundRequest req;
+    const uint16_t* start = NULL;
+    const uint16_t* p = NULL;
+    uint32_t deadline = 0;
+    bool playing = false;
+    bool holding = false;
 
-            uint16_t dur_ticks = *p++;
+    while(g_arduboy_sound_thread_running) {
+        uint32_t timeout = kArduboyToneIdleWaitMs;
+        if(playing && !holding) {
+            const int32_t remain = (int32_t)(deadline - furi_get_tick());
+            timeout = remain > 0 ? (uint32_t)remain : 0;
+        }
 
-            float vol = ardulib_tone_volume_for(freq_word);
-            uint16_t freq = ardulib_tone_strip_volume(freq_word);
+        const FuriStatus status = furi_message_queue_get(g_arduboy_sound_queue, &req, timeout);
+        __atomic_add_fetch(&g_arduboy_tone_stats.wakeups, 1u, __ATOMIC_RELAXED);
 
-            if(dur_ticks == 0) {
-                if(freq == 0) {
+        if(status == FuriStatusOk) {
+            if(!req.pattern || !g_arduboy_audio_enabled || !ardulib_tone_accept(&req)) {
+                if(playing) {
                     furi_hal_speaker_stop();
-                } else {
-                    furi_hal_speaker_start((float)freq, vol);
-                }
-
-                while(g_arduboy_sound_thread_running && g_arduboy_audio_enabled) {
-                    ArduboyToneSoundRequest nr;
-                    if(furi_message_queue_get(g_arduboy_sound_queue, &nr, 50) == FuriStatusOk) {
-                        if(!nr.pattern) {
-                            g_arduboy_tones_playing = false;
-                        } else {
-                            current_pattern = nr.pattern;
-                            start = current_pattern;
-                            p = current_pattern;
-                        }
-                        break;
-                    }
+                    furi_hal_speaker_release();
+                    playing = false;
                 }
-
-                furi_hal_speaker_stop();
-                if(!g_arduboy_tones_playing) break;
+                ardulib_tone_release_active();
+                g_arduboy_tones_playing = false;
                 continue;
             }
 
-            uint32_t dur_ms = ardulib_tone_ticks_to_ms(dur_ticks);
-            if(dur_ms == 0) dur_ms = 1;
-            const uint32_t note_deadline = timeline_ms + dur_ms;
-            timeline_ms = note_deadline;
-
-            if(freq == 0) {
-                furi_hal_speaker_stop();
-                while(g_arduboy_sound_thread_running && g_arduboy_audio_enabled) {
-                    const uint32_t now = furi_get_tick();
-                    if((int32_t)(note_deadline - now) <= 0) break;
-                    const uint32_t remain = note_deadline - now;
-                    furi_delay_ms(remain > 4 ? 4 : remain);
-                }
-            } else {
-                furi_hal_speaker_start((float)freq, vol);
-                while(g_arduboy_sound_thread_running && g_arduboy_audio_enabled) {
-                    const uint32_t now = furi_get_tick();
-                    if((int32_t)(note_deadline - now) <= 0) break;
-                    const uint32_t remain = note_deadline - now;
-                    furi_delay_ms(remain > 4 ? 4 : remain);
+            if(!playing) {
+                if(!furi_hal_speaker_acquire(50)) {
+                    ardulib_tone_release_active();
+                    g_arduboy_tones_playing = false;
+                    continue;
                 }
-                furi_hal_speaker_stop();
+                playing = true;
+                g_arduboy_tones_playing = true;
             }
+
+            start = req.pattern;
+            p = start;
+            deadline = furi_get_tick();
+        } else {
+            if(!playing || holding) continue;
+
+            const uint32_t now = furi_get_tick();
+            if((int32_t)(deadline - now) > 0) continue;
+            ardulib_tone_count_onset(deadline, now);
         }
 
-        furi_hal_speaker_stop();
-        furi_hal_speaker_release();
+        if(!ardulib_tone_start_note(start, p, deadline, holding)) {
+            furi_hal_speaker_stop();
+            furi_hal_speaker_release();
+            ardulib_tone_release_active();
+            playing = false;
+            g_arduboy_tones_playing = false;
+        }
     }
 
     if(furi_hal_speaker_is_mine()) {
@@ -125,6 +141,7 @@ static int32_t ardulib_tone_sound_thread_fn(void* /*ctx*/) {
         furi_hal_speaker_release();
     }
 
+    ardulib_tone_release_active();
     g_arduboy_tones_playing = false;
     return 0;
 }
@@ -183,6 +200,20 @@ void ardulib_tone_deinit() {
     g_arduboy_tones_playing = false;
 }
 
+void ardulib_tone_get_stats(ArduboyToneTimingStats* out) {
+    out->notes = __atomic_load_n(&g_arduboy_tone_stats.notes, __ATOMIC_RELAXED);
+    out->late_ms_total = __atomic_load_n(&g_arduboy_tone_stats.late_ms_total, __ATOMIC_RELAXED);
+    out->late_ms_max = __atomic_load_n(&g_arduboy_tone_stats.late_ms_max, __ATOMIC_RELAXED);
+    out->wakeups = __atomic_load_n(&g_arduboy_tone_stats.wakeups, __ATOMIC_RELAXED);
+}
+
+void ardulib_tone_reset_stats() {
+    __atomic_store_n(&g_arduboy_tone_stats.notes, 0u, __ATOMIC_RELAXED);
+    __atomic_store_n(&g_arduboy_tone_stats.late_ms_total, 0u, __ATOMIC_RELAXED);
+    __atomic_store_n(&g_arduboy_tone_stats.late_ms_max, 0u, __ATOMIC_RELAXED);
+    __atomic_store_n(&g_arduboy_tone_stats.wakeups, 0u, __ATOMIC_RELAXED);
+}
+
 void ArduboyTones::begin() {
     if(g_arduboy_audio_enabled) {
         ardulib_tone_init();
@@ -204,14 +235,24 @@ bool ArduboyTones::playing() {
 }
 
 void ArduboyTones::tones(const uint16_t* pattern) {
+    ArduboyToneSoundRequest req = {.pattern = pattern};
+    request_(req);
+}
+
+void ArduboyTones::tonesInSlot(const uint16_t* pattern, const volatile uint32_t* stamp) {
+    ArduboyToneSoundRequest req = {.pattern = pattern, .generation = *stamp, .stamp = stamp};
+    request_(req);
+}
+
+// Never blocks: when the queue is full the oldest request is dropped.
+void ArduboyTones::request_(const ArduboyToneSoundRequest& req) {
     if(!g_arduboy_audio_enabled) return;
-    if(!pattern) return;
+    if(!req.pattern) return;
     if(!g_arduboy_sound_queue) {
         ardulib_tone_init();
     }
     if(!g_arduboy_sound_queue) return;
 
-    ArduboyToneSoundRequest req = {.pattern = pattern};
     if(furi_message_queue_put(g_arduboy_sound_queue, &req, 0) != FuriStatusOk) {
         ArduboyToneSoundRequest dummy;
         (void)furi_message_queue_get(g_arduboy_sound_queue, &dummy, 0);
@@ -20,9 +20,34 @@ extern Arduboy2Base arduboy;
 constexpr size_t RuntimeWidth = 128u;
 constexpr size_t RuntimeHeight = 64u;
 constexpr size_t RuntimeBufferSize = (RuntimeWidth * RuntimeHeight) / 8u;
+constexpr size_t RuntimeBufferWords = RuntimeBufferSize / sizeof(uint32_t);
+
+// Frames pass between the game and the GUI through three buffers: the game
+// draws into `back`, the GUI shows `front`, and `middle` holds whichever was
+// handed over last. Each side swaps its buffer with `middle` atomically;
+// RuntimeFrameFresh marks a `middle` the GUI has not taken yet.
+constexpr uint8_t RuntimeFrameCount = 3u;
+constexpr uint8_t RuntimeFrameIndexMask = 0x03u;
+constexpr uint8_t RuntimeFrameFresh = 0x04u;
+constexpr uint8_t RuntimeFrameNone = 0xFFu;
 
 typedef struct {
-    uint8_t screen_buffer[RuntimeBufferSize];
+    uint32_t screen_buffers[RuntimeFrameCount][RuntimeBufferWords];
+    uint8_t back_index;
+    uint8_t front_index;
+    volatile uint8_t middle_index;
+    // Buffer the GUI is still clearing after handing it back, or RuntimeFrameNone.
+    volatile uint8_t clearing_index;
+    // Per buffer: published with display(true), and already all zero.
+    volatile bool clear_requested[RuntimeFrameCount];
+    volatile bool cleared[RuntimeFrameCount];
+
+    // Game thread only: hash of the last frame handed to the GUI, for
+    // skipping a commit that would show the same picture again.
+    uint32_t shown_hash;
+    bool shown_inverted;
+    bool shown_valid;
+    ArduboyDisplayStats display_stats;
 
     Gui* gui;
     Canvas* canvas;
@@ -41,7 +66,6 @@ typedef struct {
     volatile bool input_cb_enabled;
     volatile uint32_t input_cb_inflight;
     volatile bool screen_inverted;
-    volatile bool pending_clear;
 } ArduboyRuntimeState;
 
 ArduboyRuntimeState rt_state;
@@ -59,6 +83,7 @@ volatile bool g_arduboy_audio_enabled = false;
 FuriMessageQueue* g_arduboy_sound_queue = NULL;
 FuriThread* g_arduboy_sound_thread = NULL;
 volatile bool g_arduboy_sound_thread_running = false;
+volatile uint32_t g_arduboy_tones_active_gen = 0;
 volatile bool g_arduboy_tones_playing = false;
 volatile uint8_t g_arduboy_volume_mode = VOLUME_IN_TONE;
 volatile bool g_arduboy_force_high = false;
@@ -137,6 +162,51 @@ void rt_input_events_callback(const void* value, void* ctx) {
 }
 #endif
 
+static inline uint8_t* rt_frame(ArduboyRuntimeState* state, uint8_t index) {
+    return (uint8_t*)state->screen_buffers[index];
+}
+
+// GUI side. Takes the newest frame if there is one and converts it into
+// `data` a word at a time. The buffer it replaces is cleared in the same
+// pass when its frame asked for it, so the game gets it back blank.
+static void rt_present_frame(ArduboyRuntimeState* state, uint8_t* data) {
+    uint8_t released = RuntimeFrameNone;
+
+    if(__atomic_load_n(&state->middle_index, __ATOMIC_ACQUIRE) & RuntimeFrameFresh) {
+        const uint8_t old_front = state->front_index;
+        const bool clear = __atomic_load_n(&state->clear_requested[old_front], __ATOMIC_RELAXED) &&
+                           !__atomic_load_n(&state->cleared[old_front], __ATOMIC_RELAXED);
+        if(clear) {
+            __atomic_store_n(&state->clearing_index, old_front, __ATOMIC_SEQ_CST);
+            released = old_front;
+        }
+        state->front_index =
+            __atomic_exchange_n(&state->middle_index, old_front, __ATOMIC_SEQ_CST) & RuntimeFrameIndexMask;
+    }
+
+    const uint32_t* src = state->screen_buffers[state->front_index];
+    const uint32_t flip =
+        __atomic_load_n((bool*)&state->screen_inverted, __ATOMIC_ACQUIRE) ? 0u : 0xFFFFFFFFu;
+
+    if(released == RuntimeFrameNone) {
+        for(size_t i = 0; i < RuntimeBufferWords; i++) {
+            const uint32_t word = src[i] ^ flip;
+            memcpy(data + i * sizeof(uint32_t), &word, sizeof(word));
+        }
+        return;
+    }
+
+    uint32_t* zero = state->screen_buffers[released];
+    for(size_t i = 0; i < RuntimeBufferWords; i++) {
+        const uint32_t word = src[i] ^ flip;
+        memcpy(data + i * sizeof(uint32_t), &word, sizeof(word));
+        zero[i] = 0u;
+    }
+
+    __atomic_store_n(&state->cleared[released], true, __ATOMIC_RELAXED);
+    __atomic_store_n(&state->clearing_index, RuntimeFrameNone, __ATOMIC_RELEASE);
+}
+
 void rt_framebuffer_commit_callback(
     uint8_t* data,
     size_t size,
@@ -147,33 +217,81 @@ void rt_framebuffer_commit_callback(
     if(size < RuntimeBufferSize) return;
     (void)orientation;
 
-    const uint8_t* src = state->screen_buffer;
-    bool inverted = __atomic_load_n((bool*)&state->screen_inverted, __ATOMIC_ACQUIRE);
+    rt_present_frame(state, data);
+}
 
-    for(size_t i = 0; i < RuntimeBufferSize; i++) {
-        if(inverted) {
-            data[i] = src[i];
-        } else {
-            data[i] = (uint8_t)(src[i] ^ 0xFF);
-        }
+// Game side. Hands the finished frame to the GUI and points drawing at the
+// buffer that comes back: blank after display(true), otherwise a copy of
+// the frame just shown, as on the Arduboy.
+static void rt_swap_frame(ArduboyRuntimeState* state, bool clear) {
+    const uint8_t shown = state->back_index;
+    __atomic_store_n(&state->clear_requested[shown], clear, __ATOMIC_RELAXED);
+    __atomic_store_n(&state->cleared[shown], false, __ATOMIC_RELAXED);
+
+    const uint8_t back =
+        __atomic_exchange_n(&state->middle_index, (uint8_t)(shown | RuntimeFrameFresh), __ATOMIC_SEQ_CST) &
+        RuntimeFrameIndexMask;
+
+    // The GUI clears a buffer before the game can see it in `middle` again
+    // unless a frame is handed over mid-pass; wait out that pass.
+    while(__atomic_load_n(&state->clearing_index, __ATOMIC_ACQUIRE) == back) {
+        furi_delay_tick(1);
+    }
+
+    if(!clear) {
+        memcpy(rt_frame(state, back), rt_frame(state, shown), RuntimeBufferSize);
+    } else if(!__atomic_load_n(&state->cleared[back], __ATOMIC_RELAXED)) {
+        // Only a frame the GUI skipped comes back uncleared.
+        memset(rt_frame(state, back), 0x00, RuntimeBufferSize);
+    }
+
+    state->back_index = back;
+    arduboy.sBuffer = rt_frame(state, back);
+    buf = arduboy.sBuffer;
+}
+
+static uint32_t rt_frame_hash(const uint32_t* words) {
+    uint32_t h = 0x811C9DC5u;
+    for(size_t i = 0; i < RuntimeBufferWords; i++) {
+        h = (h ^ words[i]) * 0x01000193u;
+        h ^= h >> 15;
     }
+    return h;
+}
 
-    // Clear screen buffer after commit if needed (for non-view_port mode with clear)
-    if(state->pending_clear) {
-        memset(state->screen_buffer, 0x00, RuntimeBufferSize);
-        state->pending_clear = false;
+void arduboy_display_stats(ArduboyDisplayStats* out) {
+    if(!out) return;
+    if(!rt_state_initialized) {
+        memset(out, 0, sizeof(*out));
+        return;
     }
+    *out = rt_state.display_stats;
+}
+
+void arduboy_display_stats_reset(void) {
+    if(!rt_state_initialized) return;
+    memset(&rt_state.display_stats, 0, sizeof(rt_state.display_stats));
 }
 
 void rt_display(bool clear) {
     if(!rt_state_initialized) return;
     ArduboyRuntimeState* state = &rt_state;
 
-    // Set pending clear flag - actual clearing will happen in the display callback
-    // after the buffer is sent to the display
-    if(clear) {
-        state->pending_clear = true;
+    // A frame identical to the one on screen is not handed over at all; the
+    // game only needs its buffer cleared as display(true) promises.
+    const uint32_t hash = rt_frame_hash(state->screen_buffers[state->back_index]);
+    const bool inverted = __atomic_load_n((bool*)&state->screen_inverted, __ATOMIC_ACQUIRE);
+    if(state->shown_valid && state->shown_hash == hash && state->shown_inverted == inverted) {
+        state->display_stats.skipped++;
+        if(clear) memset(rt_frame(state, state->back_index), 0x00, RuntimeBufferSize);
+        return;
     }
+    state->shown_hash = hash;
+    state->shown_inverted = inverted;
+    state->shown_valid = true;
+    state->display_stats.committed++;
+
+    rt_swap_frame(state, clear);
 
 #ifdef ARDULIB_USE_VIEW_PORT
     if(state->view_port) {
@@ -186,6 +304,17 @@ void rt_display(bool clear) {
 #endif
 }
 
+// Sleeps until the next frame is due. When loop() took no frame and the
+// deadline has already passed it waits a tick rather than spin.
+void rt_wait_next_frame(uint32_t frames_before) {
+    const uint32_t deadline = arduboy.nextFrameDeadline();
+    if((int32_t)(deadline - furi_get_tick()) > 0) {
+        furi_delay_until_tick(deadline);
+    } else if(arduboy.frameCount() == frames_before) {
+        furi_delay_ms(1);
+    }
+}
+
 void rt_step_frame(ArduboyRuntimeState* state) {
     if(!state || state->exit_requested) return;
     if(furi_mutex_acquire(state->game_mutex, 0) != FuriStatusOk) return;
@@ -203,22 +332,7 @@ void rt_view_port_draw_callback(Canvas* canvas, void* context) {
     uint8_t* data = u8g2_GetBufferPtr(&canvas->fb); //canvas_get_buffer
     if(!data) return;
 
-    const uint8_t* src = state->screen_buffer;
-    bool inverted = __atomic_load_n((bool*)&state->screen_inverted, __ATOMIC_ACQUIRE);
-
-    for(size_t i = 0; i < RuntimeBufferSize; i++) {
-        if(inverted) {
-            data[i] = src[i];
-        } else {
-            data[i] = (uint8_t)(src[i] ^ 0xFF);
-        }
-    }
-
-    // Clear screen buffer after commit if needed (for view_port mode with clear)
-    if(state->pending_clear) {
-        memset(state->screen_buffer, 0x00, RuntimeBufferSize);
-        state->pending_clear = false;
-    }
+    rt_present_frame(state, data);
 }
 #endif
 
@@ -234,7 +348,13 @@ extern "C" int32_t arduboy_app(void* p) {
     state->input_cb_enabled = true;
     state->input_cb_inflight = 0;
     state->screen_inverted = false;
-    state->pending_clear = false;
+    state->back_index = 0;
+    state->middle_index = 1;
+    state->front_index = 2;
+    state->clearing_index = RuntimeFrameNone;
+    for(uint8_t i = 0; i < RuntimeFrameCount; i++) {
+        state->cleared[i] = true;
+    }
 
     if(!state->game_mutex) {
         if(state->game_mutex) furi_mutex_free(state->game_mutex);
@@ -242,18 +362,17 @@ extern "C" int32_t arduboy_app(void* p) {
         return -1;
     }
 
-    memset(state->screen_buffer, 0x00, RuntimeBufferSize);
-    buf = state->screen_buffer;
+    buf = rt_frame(state, state->back_index);
 
     // Прямая инициализация arduboy с передачей всех необходимых указателей
     arduboy.begin(
-        state->screen_buffer,
+        buf,
         &state->input_state,
         &state->input_press_latch,
         state->game_mutex,
         &state->exit_requested);
     rt_runtime_begin(
-        state->screen_buffer,
+        buf,
         &state->input_state,
         &state->input_press_latch,
         state->game_mutex,
@@ -305,8 +424,9 @@ extern "C" int32_t arduboy_app(void* p) {
     }
 
     while(!state->exit_requested) {
+        const uint32_t frames_before = arduboy.frameCount();
         rt_step_frame(state);
-        furi_delay_ms(1);
+        rt_wait_next_frame(frames_before);
     }
 
     arduboy.audio.off();
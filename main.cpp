@@ -33,8 +33,8 @@ void isEnemyVisible(
     bool justEnteredRoom);
 
 bool testScroll(GamePlay& gamePlay, Prince& prince, Level& level);
-void pushSequence();
-void processJump(uint24_t pos);
+void pushSequence(const uint16_t *sequence);
+void processJump(const uint16_t *jump);
 void processRunJump(Prince& prince, Level& level, bool testEnemy);
 void processStandingJump(Prince& prince, Level& level);
 void initFlash(Prince& prince, Level& level, FlashType flashType);
@@ -48,10 +48,10 @@ void pushDead(Enemy& entity, bool clear);
 void showSign(Prince& prince, Level& level);
 void playGrab();
 void fixPosition();
-uint8_t getImageIndexFromStance(uint16_t stance);
 void getStance_Offsets(Direction direction, Point& offset, int16_t stance);
 void processRunningTurn();
 void saveCookie(bool enableLEDs);
+bool loadCookie();
 void bindRuntimeStacks();
 void restoreRuntimeAfterLoad();
 void handleBlades();
@@ -70,6 +70,8 @@ void renderNumber(uint8_t x, uint8_t y, uint8_t number);
 void renderNumber_Small(uint8_t x, uint8_t y, uint8_t number);
 void renderNumber_Upright(uint8_t x, uint8_t y, uint8_t number);
 void renderTorches(uint8_t x1, uint8_t x2, uint8_t y);
+void renderBackgroundTiles(uint8_t yOffset);
+void renderCollapsedTile(int8_t x, int8_t y, uint8_t yOffset);
 
 #include "game/PrinceOfArabia.cpp"
 #include "game/PrinceOfArabia_Game.cpp"
@@ -139,7 +141,8 @@ void setup() {
     arduboy.setFrameRate(Constants::FrameRate);
 
     FX::begin(FX_DATA_PAGE, FX_SAVE_PAGE);
-    const bool hasSave = FX::loadGameState((uint8_t*)&cookie, sizeof(cookie));
+    StanceTables::load();
+    const bool hasSave = loadCookie();
 
     prince.setStack(&princeStack);
 
@@ -169,8 +172,10 @@ void loop() {
     if(handleExitRequest()) return;
 
 #ifndef SAVE_MEMORY_SOUND
+    FX::setTraceTag(FxTraceTagSound);
     sound.fillBufferFromFX();
 #endif
+    FX::setTraceTag(FxTraceTagLogic);
 
     switch(gamePlay.gameState) {
 #ifndef SAVE_MEMORY_PPOT
@@ -1,49 +1,168 @@
 #include "ArduboyTonesFX.h"
 
 ArduboyTones ArduboyTonesFX::backend_ = ArduboyTones(false);
-uint16_t ArduboyTonesFX::sequence_[ArduboyTonesFX::MaxWords] = {0};
+uint16_t ArduboyTonesFX::sequence_[ArduboyTonesFX::SequenceSlots][ArduboyTonesFX::MaxWords] = {};
+volatile uint32_t ArduboyTonesFX::sequence_stamp_[ArduboyTonesFX::SequenceSlots] = {};
+uint8_t ArduboyTonesFX::sequence_next_ = 0;
+uint32_t ArduboyTonesFX::generation_ = 0;
 bool (*ArduboyTonesFX::outputEnabled_)() = nullptr;
 
+ArduboyTonesFX::CacheSlot ArduboyTonesFX::cache_[ArduboyTonesFX::CacheSlots] = {};
+uint16_t ArduboyTonesFX::cache_arena_[ArduboyTonesFX::CacheSlots][ArduboyTonesFX::CacheSlotWords] = {};
+uint32_t ArduboyTonesFX::cache_clock_ = 0;
+ArduboyTonesFX::CacheStats ArduboyTonesFX::cache_stats_ = {0, 0, 0};
+
 ArduboyTonesFX::ArduboyTonesFX(bool (*outEn)(), uint16_t* tonesArray, uint8_t tonesArrayLen) {
     UNUSED(tonesArray);
     UNUSED(tonesArrayLen);
     outputEnabled_ = outEn;
 }
 
-size_t ArduboyTonesFX::decodeFromFX_(uint24_t addr) {
+// Takes a slot for rewriting: its stamp goes to 0 first, so a request still
+// queued for the old contents is skipped, then the active generation is
+// checked. The sound thread does the same in the other order, so one of the
+// two always sees the other (both are sequentially consistent).
+bool ArduboyTonesFX::claimSlot_(volatile uint32_t& stamp) {
+    const uint32_t gen = stamp;
+    __atomic_store_n(&stamp, 0u, __ATOMIC_SEQ_CST);
+
+    if(gen != 0 && __atomic_load_n(&g_arduboy_tones_active_gen, __ATOMIC_SEQ_CST) == gen) {
+        __atomic_store_n(&stamp, gen, __ATOMIC_RELEASE);
+        return false;
+    }
+    return true;
+}
+
+void ArduboyTonesFX::publishSlot_(volatile uint32_t& stamp) {
+    if(++generation_ == 0) generation_ = 1;
+    __atomic_store_n(&stamp, generation_, __ATOMIC_RELEASE);
+}
+
+// Decodes into the next sequence_ slot the sound thread is not playing and
+// returns its index. Only one generation is active, so with two slots the
+// second candidate is always free.
+uint8_t ArduboyTonesFX::decodeFromFX_(uint24_t addr) {
+    uint8_t s = sequence_next_;
+    for(uint8_t i = 0; i < SequenceSlots; i++) {
+        s = (uint8_t)((sequence_next_ + i) % SequenceSlots);
+        if(claimSlot_(sequence_stamp_[s])) break;
+    }
+    sequence_next_ = (uint8_t)((s + 1) % SequenceSlots);
+
+    bool truncated;
+    decodeInto_(addr, sequence_[s], MaxWords, truncated);
+    publishSlot_(sequence_stamp_[s]);
+    return s;
+}
+
+// Decodes freq/dur pairs up to TONES_END or TONES_REPEAT. A sequence that
+// does not fit is cut short and terminated, with `truncated` set.
+size_t ArduboyTonesFX::decodeInto_(uint24_t addr, uint16_t* dst, size_t capacity, bool& truncated) {
     size_t i = 0;
+    truncated = true;
 
-    FX::seekData(addr);
+    FX::Reader reader(addr);
 
-    while(i + 1 < MaxWords) {
-        const uint16_t freq = FX::readPendingUInt16();
-        sequence_[i++] = freq;
+    while(i + 1 < capacity) {
+        const uint16_t freq = reader.readUInt16();
+        dst[i++] = freq;
 
         if(freq == TONES_END || freq == TONES_REPEAT) {
+            truncated = false;
             break;
         }
 
-        const uint16_t dur = FX::readPendingUInt16();
-        sequence_[i++] = dur;
+        const uint16_t dur = reader.readUInt16();
+        dst[i++] = dur;
     }
 
-    if(i == 0 || (sequence_[i - 1] != TONES_END && sequence_[i - 1] != TONES_REPEAT)) {
-        if(i < MaxWords) {
-            sequence_[i++] = TONES_END;
+    if(truncated) {
+        if(i < capacity) {
+            dst[i++] = TONES_END;
         } else {
-            sequence_[MaxWords - 1] = TONES_END;
+            dst[capacity - 1] = TONES_END;
         }
     }
 
-    FX::readEnd();
     return i;
 }
 
+const uint16_t* ArduboyTonesFX::cachedSequence_(uint24_t table, uint8_t index, const volatile uint32_t*& stamp) {
+    cache_clock_++;
+
+    for(uint8_t s = 0; s < CacheSlots; s++) {
+        CacheSlot& slot = cache_[s];
+        if(slot.last_use && slot.table == table && slot.index == index) {
+            slot.last_use = cache_clock_;
+            cache_stats_.hits++;
+            stamp = &slot.stamp;
+            return cache_arena_[s];
+        }
+    }
+
+    // Least recently used slot the sound thread is not playing. That is
+    // normally the LRU one; at most one slot can be skipped.
+    uint8_t victim = 0;
+    uint8_t skipped = 0;
+    for(uint8_t attempt = 0; attempt < 2; attempt++) {
+        bool found = false;
+        for(uint8_t s = 0; s < CacheSlots; s++) {
+            if(skipped & (1u << s)) continue;
+            if(!found || cache_[s].last_use < cache_[victim].last_use) {
+                victim = s;
+                found = true;
+            }
+        }
+        if(claimSlot_(cache_[victim].stamp)) break;
+        skipped |= (uint8_t)(1u << victim);
+    }
+
+    CacheSlot& slot = cache_[victim];
+    const uint24_t addr = FX::readIndexedUInt24(table, index);
+
+    bool truncated;
+    decodeInto_(addr, cache_arena_[victim], CacheSlotWords, truncated);
+
+    if(truncated) {
+        slot.last_use = 0;
+        cache_stats_.uncached++;
+        const uint8_t s = decodeFromFX_(addr);
+        stamp = &sequence_stamp_[s];
+        return sequence_[s];
+    }
+
+    slot.table = table;
+    slot.index = index;
+    slot.last_use = cache_clock_;
+    publishSlot_(slot.stamp);
+    cache_stats_.misses++;
+    stamp = &slot.stamp;
+    return cache_arena_[victim];
+}
+
 void ArduboyTonesFX::tonesFromFX(uint24_t tones) {
     if(outputEnabled_ && !outputEnabled_()) return;
 
-    decodeFromFX_(tones);
-    backend_.tonesInRAM(sequence_);
+    const uint8_t s = decodeFromFX_(tones);
+    backend_.tonesInSlot(sequence_[s], &sequence_stamp_[s]);
+}
+
+void ArduboyTonesFX::tonesFromFX(uint24_t table, uint8_t index) {
+    if(outputEnabled_ && !outputEnabled_()) return;
+
+    const volatile uint32_t* stamp;
+    const uint16_t* sequence = cachedSequence_(table, index, stamp);
+    backend_.tonesInSlot(sequence, stamp);
+}
+
+void ArduboyTonesFX::getCacheStats(CacheStats& stats) {
+    stats = cache_stats_;
+}
+
+void ArduboyTonesFX::resetCacheStats() {
+    cache_stats_.hits = 0;
+    cache_stats_.misses = 0;
+    cache_stats_.uncached = 0;
 }
 
 void ArduboyTonesFX::fillBufferFromFX() {
@@ -16,17 +16,59 @@ public:
     }
 
     static void tonesFromFX(uint24_t tones);
+
+    // Plays entry `index` of an FX table of sequence addresses (Sounds::Table).
+    // Decoded sequences are kept in a small LRU keyed by (table, index), so
+    // retriggering a recent one hands the backend a pointer without reading FX.
+    static void tonesFromFX(uint24_t table, uint8_t index);
     static void fillBufferFromFX();
     static void noTone();
     static void volumeMode(uint8_t mode);
     static bool playing();
 
+    struct CacheStats {
+        uint32_t hits;
+        uint32_t misses; // decoded from FX into a slot
+        uint32_t uncached; // longer than a slot, decoded into a sequence_ slot
+    };
+    static void getCacheStats(CacheStats& stats);
+    static void resetCacheStats();
+
 private:
     static constexpr size_t MaxWords = 512;
 
+    // Sequences are handed to the sound thread by pointer, so every buffer
+    // is a slot with a generation stamp (ArduboyAudioState.h) and is only
+    // rewritten once the sound thread is not playing it. Two full-size
+    // slots take uncached sequences in turn, one of them is always free.
+    static constexpr uint8_t SequenceSlots = 2;
+
+    // Every effect fits a cache slot; only the longer music does not.
+    static constexpr uint8_t CacheSlots = 8;
+    static constexpr size_t CacheSlotWords = 64;
+
+    struct CacheSlot {
+        uint24_t table;
+        uint32_t last_use; // 0 when the slot is empty
+        uint8_t index;
+        volatile uint32_t stamp;
+    };
+
     static ArduboyTones backend_;
-    static uint16_t sequence_[MaxWords];
+    static uint16_t sequence_[SequenceSlots][MaxWords];
+    static volatile uint32_t sequence_stamp_[SequenceSlots];
+    static uint8_t sequence_next_;
+    static uint32_t generation_;
     static bool (*outputEnabled_)();
 
-    static size_t decodeFromFX_(uint24_t addr);
+    static CacheSlot cache_[CacheSlots];
+    static uint16_t cache_arena_[CacheSlots][CacheSlotWords];
+    static uint32_t cache_clock_;
+    static CacheStats cache_stats_;
+
+    static bool claimSlot_(volatile uint32_t& stamp);
+    static void publishSlot_(volatile uint32_t& stamp);
+    static uint8_t decodeFromFX_(uint24_t addr);
+    static size_t decodeInto_(uint24_t addr, uint16_t* dst, size_t capacity, bool& truncated);
+    static const uint16_t* cachedSequence_(uint24_t table, uint8_t index, const volatile uint32_t*& stamp);
 };
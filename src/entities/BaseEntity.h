@@ -4,6 +4,8 @@
 #include "../utils/Constants.h"
 #include "../utils/Stack.h"
 #include "../entities/Structs.h"
+#include "../utils/SaveStream.h"
+#include "../utils/StanceTables.h"
 
 class BaseEntity {
 
@@ -142,20 +144,17 @@ class BaseEntity {
         void getImageDetails(ImageDetails &imageDetails) {
 
             uint8_t imageIndex = getImageIndexFromStance(this->stance);
-            uint24_t startPos = static_cast<uint24_t>(Constants::Prince_ImageDetails + ((imageIndex - 1) * 3));
             int8_t direction = this->getDirection() == Direction::Left ? -1 : 1;
 
-            FX::seekData(startPos);
-            uint16_t data = FX::readPendingUInt16();
-            imageDetails.reach = static_cast<int8_t>((data >> 8) * direction);
-            imageDetails.toe = static_cast<int8_t>((data & 0xFF) * direction);
-            imageDetails.heel = static_cast<int8_t>(FX::readEnd() * direction);
+            uint8_t reach, toe, heel;
+            StanceTables::getImageDetails(imageIndex, reach, toe, heel);
+            imageDetails.reach = static_cast<int8_t>(reach * direction);
+            imageDetails.toe = static_cast<int8_t>(toe * direction);
+            imageDetails.heel = static_cast<int8_t>(heel * direction);
 
             #ifdef DEBUG_IMAGE_DETAILS
             DEBUG_PRINT(F("ImageIndex: "));
             DEBUG_PRINT(imageIndex);
-            DEBUG_PRINT(F(", startPos: "));
-            DEBUG_PRINT((int32_t)startPos);
             DEBUG_PRINT(F(", direction: "));
             DEBUG_PRINT((uint8_t)direction);
             DEBUG_PRINT(F(", reach: "));
@@ -173,11 +172,55 @@ class BaseEntity {
 
         uint8_t getImageIndexFromStance(uint16_t stance) {
 
-            FX::seekData(Constants::StanceToImageXRefFX + stance);
-            uint8_t image = FX::readEnd();
-
-            return image;
+            return StanceTables::getImageIndex(stance);
             
         }
 
+
+        // ----------------------------------------------------------------------------------------------------------
+        //  Save / restore.  Direction and status share a byte, location is rebuilt from x / y by the owner.
+
+        static constexpr uint8_t SaveSize = 19;
+
+        void serialize(SaveWriter &writer) {
+
+            writer.writeUInt16(this->stance);
+            writer.writeUInt16(this->prevStance);
+            writer.writeInt16(this->x);
+            writer.writeInt16(this->y);
+            writer.writeInt16(this->prevY);
+            writer.writeUInt8(this->x_Tile);
+            writer.writeUInt8(this->x_LeftEntry);
+            writer.writeUInt8(this->x_RightEntry);
+            writer.writeUInt8(this->x_LeftExtent);
+            writer.writeUInt8(this->x_RightExtent);
+            writer.writeUInt8(this->health);
+            writer.writeUInt8(this->healthMax);
+            writer.writeUInt8((static_cast<uint8_t>(this->direction) << 4) | static_cast<uint8_t>(this->status));
+            writer.writeUInt8(static_cast<uint8_t>(this->enemyType));
+
+        }
+
+        void deserialize(SaveReader &reader) {
+
+            this->stance = reader.readUInt16();
+            this->prevStance = reader.readUInt16();
+            this->x = reader.readInt16();
+            this->y = reader.readInt16();
+            this->prevY = reader.readInt16();
+            this->x_Tile = reader.readUInt8();
+            this->x_LeftEntry = reader.readUInt8();
+            this->x_RightEntry = reader.readUInt8();
+            this->x_LeftExtent = reader.readUInt8();
+            this->x_RightExtent = reader.readUInt8();
+            this->health = reader.readUInt8();
+            this->healthMax = reader.readUInt8();
+
+            uint8_t directionStatus = reader.readUInt8();
+            this->direction = static_cast<Direction>(directionStatus >> 4);
+            this->status = static_cast<Status>(directionStatus & 0x0F);
+            this->enemyType = static_cast<EnemyType>(reader.readUInt8());
+
+        }
+
 };
\ No newline at end of file
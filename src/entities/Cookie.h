@@ -2,6 +2,7 @@
 
 #include "../utils/Arduboy2Ext.h"
 #include "../utils/Constants.h"
+#include "../utils/SaveStream.h"
 #include "GamePlay.h"
 #include "Level.h"
 #include "Prince.h"
@@ -34,6 +35,108 @@ struct Cookie {
     TitleScreenMode mode;
 
 
+    // Saves are written field by field rather than as a copy of the struct.
+    // Bump SaveVersion whenever the layout below changes; older saves are
+    // then ignored rather than misread.
+
+    static constexpr uint8_t SaveMagic = 0xB5;
+    static constexpr uint8_t SaveVersion = 1;
+
+    #ifndef SAVE_MEMORY_ENEMY
+    static constexpr uint16_t SaveSize = 8 + GamePlay::SaveSize + Level::SaveSize + Prince::SaveSize + Enemy::SaveSize;
+    #else
+    static constexpr uint16_t SaveSize = 8 + GamePlay::SaveSize + Level::SaveSize + Prince::SaveSize;
+    #endif
+
+    uint16_t serialize(uint8_t *buffer, uint16_t capacity) {
+
+        SaveWriter writer(buffer, capacity);
+
+        writer.writeUInt8(SaveMagic);
+        writer.writeUInt8(SaveVersion);
+
+        uint8_t flags = (this->hasSavedLevel ? 1 : 0) | (this->hasSavedScore ? 2 : 0);
+        #ifdef POP_OR_POA
+        if (this->pop) flags = flags | 4;
+        #endif
+
+        writer.writeUInt8(flags);
+        writer.writeUInt8(this->highMin);
+        writer.writeUInt8(this->highSec);
+        writer.writeUInt16(this->highSaves);
+        writer.writeUInt8(static_cast<uint8_t>(this->mode));
+
+        this->gamePlay.serialize(writer);
+        this->level.serialize(writer, this->gamePlay);
+        this->prince.serialize(writer);
+
+        #ifndef SAVE_MEMORY_ENEMY
+        this->enemy.serialize(writer);
+        #endif
+
+        return writer.hasFailed() ? 0 : writer.getSize();
+
+    }
+
+    // Walks a record without decoding it: true if it is this version and
+    // every part is there, ending exactly at the end of the buffer ..
+
+    static bool isValid(const uint8_t *buffer, uint16_t size) {
+
+        SaveReader reader(buffer, size);
+
+        if (reader.readUInt8() != SaveMagic) return false;
+        if (reader.readUInt8() != SaveVersion) return false;
+
+        reader.skip(6 + GamePlay::SaveSize);
+        Level::skip(reader);
+        reader.skip(Prince::SaveSize);
+
+        #ifndef SAVE_MEMORY_ENEMY
+        Enemy::skip(reader);
+        #endif
+
+        return !reader.hasFailed() && reader.atEnd();
+
+    }
+
+    // The record is checked before any of it is decoded, so a truncated or
+    // corrupt save leaves the game as it was.  The level's tiles are loaded
+    // once the rest is in place ..
+
+    bool deserialize(const uint8_t *buffer, uint16_t size) {
+
+        if (!isValid(buffer, size)) return false;
+
+        SaveReader reader(buffer, size);
+        reader.skip(2);                         // Magic and version.
+
+        uint8_t flags = reader.readUInt8();
+        this->hasSavedLevel = (flags & 1) != 0;
+        this->hasSavedScore = (flags & 2) != 0;
+        #ifdef POP_OR_POA
+        this->pop = (flags & 4) != 0;
+        #endif
+
+        this->highMin = reader.readUInt8();
+        this->highSec = reader.readUInt8();
+        this->highSaves = reader.readUInt16();
+        this->mode = static_cast<TitleScreenMode>(reader.readUInt8());
+
+        this->gamePlay.deserialize(reader);
+        this->level.deserialize(reader, this->gamePlay, this->prince);
+        this->prince.deserialize(reader);
+
+        #ifndef SAVE_MEMORY_ENEMY
+        this->enemy.deserialize(reader);
+        #endif
+
+        this->level.loadMap(this->gamePlay);
+        return true;
+
+    }
+
+
     TitleScreenMode getMode()               { return this->mode; }
 
     void setMode(TitleScreenMode mode) {
@@ -158,5 +158,64 @@ class Enemy : public BaseStack {
 
         }
 
+        // Only the bases in use are saved; the rest are reset on load.
+
+        static constexpr uint16_t SaveSize = 5 + (Constants::EnemyCount * BaseEntity::SaveSize);
+
+        void serialize(SaveWriter &writer) {
+
+            uint8_t used = this->count > this->activeEnemy ? this->count : this->activeEnemy + 1;
+            if (used > Constants::EnemyCount) used = Constants::EnemyCount;
+
+            writer.writeUInt8(this->count);
+            writer.writeUInt8(this->activeEnemy);
+            writer.writeUInt8(this->moveCount);
+            writer.writeUInt8(static_cast<uint8_t>(this->moveDirection));
+            writer.writeUInt8(used);
+
+            for (uint8_t i = 0; i < used; i++) {
+                this->base[i].serialize(writer);
+            }
+
+        }
+
+        static void skip(SaveReader &reader) {
+
+            reader.skip(4);
+
+            uint8_t used = reader.readUInt8();
+            if (used > Constants::EnemyCount) used = Constants::EnemyCount;
+
+            reader.skip(used * BaseEntity::SaveSize);
+
+        }
+
+        void deserialize(SaveReader &reader) {
+
+            this->count = reader.readUInt8();
+            this->activeEnemy = reader.readUInt8();
+            this->moveCount = reader.readUInt8();
+            this->moveDirection = static_cast<Direction>(reader.readUInt8());
+
+            uint8_t used = reader.readUInt8();
+            if (used > Constants::EnemyCount) used = Constants::EnemyCount;
+            if (this->activeEnemy >= Constants::EnemyCount) this->activeEnemy = 0;
+
+            for (uint8_t i = 0; i < Constants::EnemyCount; i++) {
+
+                if (i < used) {
+                    this->base[i].deserialize(reader);
+                }
+                else {
+                    this->base[i] = BaseEntity();
+                }
+
+                this->base[i].getPosition().x = this->base[i].getX();
+                this->base[i].getPosition().y = this->base[i].getY();
+
+            }
+
+        }
+
 
 };
\ No newline at end of file
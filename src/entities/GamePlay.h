@@ -2,6 +2,7 @@
 
 #include "../utils/Arduboy2Ext.h"
 #include "../utils/Constants.h"
+#include "../utils/SaveStream.h"
 
 struct GamePlay {
 
@@ -95,4 +96,38 @@ struct GamePlay {
         
     }
 
+    static constexpr uint8_t SaveSize = 12;
+
+    void serialize(SaveWriter &writer) {
+
+        writer.writeUInt8(static_cast<uint8_t>(this->gameState));
+        writer.writeUInt16(this->frameCount);
+        writer.writeUInt8(this->grab);
+        writer.writeUInt8(this->level);
+        writer.writeUInt8(this->timer_Sec);
+        writer.writeUInt8(this->timer_Min);
+        writer.writeUInt8(this->saves);
+        writer.writeUInt8(this->crouchTimer);
+        writer.writeUInt8(this->timeRemaining);
+        writer.writeUInt8(this->startOfLevelHealth);
+        writer.writeUInt8(this->startOfLevelHealthMax);
+
+    }
+
+    void deserialize(SaveReader &reader) {
+
+        this->gameState = static_cast<GameState>(reader.readUInt8());
+        this->frameCount = reader.readUInt16();
+        this->grab = reader.readUInt8();
+        this->level = reader.readUInt8();
+        this->timer_Sec = reader.readUInt8();
+        this->timer_Min = reader.readUInt8();
+        this->saves = reader.readUInt8();
+        this->crouchTimer = reader.readUInt8();
+        this->timeRemaining = reader.readUInt8();
+        this->startOfLevelHealth = reader.readUInt8();
+        this->startOfLevelHealthMax = reader.readUInt8();
+
+    }
+
 };
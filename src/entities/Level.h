@@ -6,6 +6,8 @@
 #include "Enemy.h"   
 #include "../utils/Constants.h"
 #include "../utils/Stack.h"
+#include "../utils/SaveStream.h"
+#include "../utils/BackgroundCache.h"
 #include "Item.h"
 
 #define TILE_NONE -1
@@ -96,12 +98,63 @@ struct Level {
         uint8_t yOffset = 0;                        // Ofset when rendering.
         Direction yOffsetDir = Direction::None;     // Ofset movement
 
-        int8_t bg[5][22]; // 6 + 10 + 6
-        int8_t fg[5][22];
+        // The whole level's tiles, width x height row-major, decoded once by
+        // loadMap().  Static so they stay out of the Cookie ..
+
+        static int8_t bg[Constants::Level_Tiles_Max];
+        static int8_t fg[Constants::Level_Tiles_Max];
+
+    public:
+
+        // Level used to carry 5 x 22 bg / fg windows ahead of flash, and saves
+        // from before the Cookie serializer are a copy of that layout ..
+
+        static constexpr uint8_t LegacyWindowSize = 2 * 5 * 22;
+
+    private:
+
         Flash flash;
         Sign sign;
         Item items[Constants::Items_Count];
 
+    public:
+
+        // An item that can show in the current room: its screen position at
+        // yOffset 0 and the render passes that draw it ..
+
+        struct VisibleItem {
+
+            static constexpr uint8_t Background = 1;
+            static constexpr uint8_t Foreground = 2;
+            static constexpr uint8_t EdgeTile = 4;
+
+            uint8_t idx;
+            uint8_t passes;
+            int16_t x;
+            int16_t y;
+
+        };
+
+        // Columns and rows, relative to the room, that an item image can reach
+        // the screen from.  A gate is drawn 5 pixels left of its tile, an exit
+        // door 7 right and a decorative door 21 above, and yOffset scrolls up
+        // to a tile and a bit.  A collapsing floor can fall into view from any
+        // row above ..
+
+        static constexpr int8_t VisibleItems_Left = -2;
+        static constexpr int8_t VisibleItems_Right = 11;
+        static constexpr int8_t VisibleItems_Top = -1;
+        static constexpr int8_t VisibleItems_Bottom = 4;
+
+    private:
+
+        // Rebuilt by updateVisibleItems() after the room changes or an item
+        // changes type or tile.  Static so they stay out of the Cookie ..
+
+        static VisibleItem visibleItems[Constants::Items_Count];
+        static uint8_t visibleItemCount;
+        static bool visibleItemsValid;
+
     public:
 
         uint8_t getWidth()                      { return this->width; }
@@ -116,11 +169,100 @@ struct Level {
 
         void setWidth(uint8_t val)              { this->width = val; }
         void setHeight(uint8_t val)             { this->height = val; }
-        void setXLocation(uint8_t val)          { this->xLoc = val; }
-        void setYLocation(uint8_t val)          { this->yLoc = val; }
+        void setXLocation(uint8_t val)          { this->xLoc = val; BackgroundCache::invalidate(); this->invalidateVisibleItems(); }
+        void setYLocation(uint8_t val)          { this->yLoc = val; BackgroundCache::invalidate(); this->invalidateVisibleItems(); }
         void setYOffset(uint8_t val)            { this->yOffset = val; }
         void setYOffsetDir(Direction val)       { this->yOffsetDir = val; }
 
+        uint8_t getVisibleItemCount()           { return visibleItemCount; }
+        VisibleItem &getVisibleItem(uint8_t idx) { return visibleItems[idx]; }
+        void invalidateVisibleItems()           { visibleItemsValid = false; }
+
+
+        // The passes of render() that draw an item type ..
+
+        static uint8_t getItemPasses(ItemType itemType) {
+
+            switch (itemType) {
+
+                case ItemType::Spikes:
+                case ItemType::Blade:
+                    return VisibleItem::Background | VisibleItem::Foreground;
+
+                case ItemType::FloorButton1:
+                case ItemType::FloorButton3_UpOnly:
+                case ItemType::ExitDoor_Button:
+                case ItemType::Mirror_Button:
+                case ItemType::ExitDoor_Button_Cropped:
+                case ItemType::FloorButton2:
+                case ItemType::FloorButton4:
+                case ItemType::FloorButton3_DownOnly:
+                    return VisibleItem::Background | VisibleItem::EdgeTile;
+
+                case ItemType::Sword:
+                case ItemType::Skeleton:
+                case ItemType::ExitDoor_SelfOpen:
+                case ItemType::ExitDoor_ButtonOpen:
+                case ItemType::Gate:
+                case ItemType::Gate_StayClosed:
+                case ItemType::Gate_StayOpen:
+                case ItemType::EntryDoor:
+                case ItemType::EntryDoor_Cropped:
+                case ItemType::EntryDoor_HalfTileLeft:
+                case ItemType::CollapsingFloor:
+                case ItemType::CollpasedFloor:
+                case ItemType::Potion_Small:
+                case ItemType::Potion_Large:
+                case ItemType::Potion_Poison:
+                case ItemType::Potion_Float:
+                case ItemType::Mirror:
+                case ItemType::FloorButton_NoEdgeTile:
+                case ItemType::AppearingFloor:
+                case ItemType::DecorativeDoor:
+                    return VisibleItem::Background;
+
+                default:
+                    return 0;
+
+            }
+
+        }
+
+
+        // List the items render() could draw in the current room, in item
+        // order so they are drawn in the same order as before ..
+
+        void updateVisibleItems() {
+
+            if (visibleItemsValid) return;
+
+            visibleItemCount = 0;
+
+            for (uint8_t i = 0; i < Constants::Items_Count; i++) {
+
+                Item &item = this->items[i];
+                uint8_t passes = getItemPasses(item.itemType);
+
+                if (passes == 0) continue;
+
+                int16_t x = item.data.location.x - this->xLoc;
+                int16_t y = item.data.location.y - this->yLoc;
+
+                if (x < VisibleItems_Left || x > VisibleItems_Right || y > VisibleItems_Bottom) continue;
+                if (y < VisibleItems_Top && item.itemType != ItemType::CollapsingFloor) continue;
+
+                VisibleItem &visibleItem = visibleItems[visibleItemCount++];
+                visibleItem.idx = i;
+                visibleItem.passes = passes;
+                visibleItem.x = x * Constants::TileWidth;
+                visibleItem.y = (y * Constants::TileHeight) + Constants::ScreenTopOffset;
+
+            }
+
+            visibleItemsValid = true;
+
+        }
+
 
     public:
 
@@ -358,7 +500,7 @@ struct Level {
                                                 if (item.data.gate.position == 0) {
 
                                                     #ifndef SAVE_MEMORY_SOUND
-                                                        sound.tonesFromFX(Sounds::GateGoingUp);
+                                                        sound.tonesFromFX(Sounds::Table, static_cast<uint8_t>(SoundIndex::GateGoingUp));
                                                     #endif    
 
                                                 }
@@ -398,7 +540,7 @@ struct Level {
                                             if (item.data.gate.position == 9) {
 
                                                 #ifndef SAVE_MEMORY_SOUND
-                                                    sound.tonesFromFX(Sounds::GateGoingDown);
+                                                    sound.tonesFromFX(Sounds::Table, static_cast<uint8_t>(SoundIndex::GateGoingDown));
                                                 #endif    
 
                                             }
@@ -479,6 +621,8 @@ struct Level {
 
                                 if (item.data.collapsingFloor.distanceFallen >= item.data.collapsingFloor.distToFall) {
 
+                                    this->invalidateVisibleItems();
+
                                     if (item.data.collapsingFloor.distToFall == 254) {
 
                                         item.itemType = ItemType::None;
@@ -707,6 +851,23 @@ struct Level {
 
         }
 
+        // Tile at absolute map coordinates.  Cells left of or above the level,
+        // or past its last row, read as empty (BG) or solid wall (FG) ..
+
+        int8_t getMapTile(Layer layer, int16_t x, int16_t y) {
+
+            if (x < 0 || y < 0) return (layer == Layer::Foreground ? TILE_FG_WALL_1 : TILE_NONE);
+
+            uint16_t idx = (y * this->width) + x;
+
+            if (idx >= this->width * this->height || idx >= Constants::Level_Tiles_Max) {
+                return (layer == Layer::Foreground ? TILE_FG_WALL_1 : TILE_NONE);
+            }
+
+            return (layer == Layer::Foreground ? fg[idx] : bg[idx]);
+
+        }
+
         int8_t getTile(Layer layer, int8_t x, int8_t y, int8_t returnCollapsingTile) { 
 
             if (x <= -6 || x > 15) return TILE_NONE;
@@ -721,14 +882,14 @@ struct Level {
                     DEBUG_PRINT(F(","));
                     DEBUG_PRINT(y);
                     DEBUG_PRINT(F(") = "));
-                    DEBUG_PRINTLN(fg[y + 1][x + 3]);
+                    DEBUG_PRINTLN(this->getMapTile(Layer::Foreground, this->xLoc + x, this->yLoc + y));
                     #endif
 
-                    return fg[y + 1][x + 6];
+                    return this->getMapTile(Layer::Foreground, this->xLoc + x, this->yLoc + y);
 
                 case Layer::Background:
                     {
-                        int8_t tile = bg[y + 1][x + 6];
+                        int8_t tile = this->getMapTile(Layer::Background, this->xLoc + x, this->yLoc + y);
 
                         #if defined(DEBUG) && defined(DEBUG_GET_TILE)
                         DEBUG_PRINT(F("getTile(BG, "));
@@ -4,75 +4,196 @@ void loadItems(uint8_t level, Prince &prince) {
     FX::readBytes((uint8_t*)&this->items, Constants::Items_Count * sizeof(Item));
     FX::readEnd();
 
+    this->invalidateVisibleItems();
+
 #ifdef DEBUG_LEVELS
     prince.setSword(level > 1);
 #endif
 
 }
 
-void loadMap(GamePlay &gamePlay) {
+// Save / restore.  The bg / fg tiles are not saved, the caller reloads them
+// with loadMap() once the whole save has been read.  Items are saved as a
+// bitmask of the ones that differ from the level's defaults in FX, followed
+// by those items ..
+
+static constexpr uint16_t SaveSize = 6 + sizeof(Flash) + sizeof(Sign) + ((Constants::Items_Count + 7) / 8) + (Constants::Items_Count * sizeof(Item));
+
+void serialize(SaveWriter &writer, GamePlay &gamePlay) {
+
+    writer.writeUInt8(this->width);
+    writer.writeUInt8(this->height);
+    writer.writeUInt8(this->xLoc);
+    writer.writeUInt8(this->yLoc);
+    writer.writeUInt8(this->yOffset);
+    writer.writeUInt8(static_cast<uint8_t>(this->yOffsetDir));
+    writer.writeBytes(&this->flash, sizeof(Flash));
+    writer.writeBytes(&this->sign, sizeof(Sign));
+
+    uint8_t *changed = writer.reserve((Constants::Items_Count + 7) / 8);
+    if (changed == nullptr) return;
+
+    memset(changed, 0, (Constants::Items_Count + 7) / 8);
+
+    FX::seekData(FX::readIndexedUInt24(Levels::Level_Items, gamePlay.level));
+
+    for (uint8_t i = 0; i < Constants::Items_Count; i++) {
+
+        Item item;
+        FX::readBytes((uint8_t*)&item, sizeof(Item));
+
+        if (memcmp(&item, &this->items[i], sizeof(Item)) != 0) {
+            changed[i / 8] |= (1 << (i % 8));
+            writer.writeBytes(&this->items[i], sizeof(Item));
+        }
 
-    uint8_t offset = 0;
-    
-    if (this->xLoc) {
-        offset = this->xLoc - 6;
     }
 
-    // Background ..
+    FX::readEnd();
+
+}
+
+static void skip(SaveReader &reader) {
+
+    reader.skip(6 + sizeof(Flash) + sizeof(Sign));
 
-    for (uint8_t x = 0; x < 5 * 22; x++) {
+    const uint8_t *changed = reader.take((Constants::Items_Count + 7) / 8);
+    if (changed == nullptr) return;
+
+    uint16_t count = 0;
+
+    for (uint8_t i = 0; i < Constants::Items_Count; i++) {
+
+        if (changed[i / 8] & (1 << (i % 8))) count++;
 
-        *(&bg[0][0] + x) = TILE_NONE;
-        
     }
 
-    for (int8_t y = this->yLoc - 1; y < (int8_t)(this->yLoc + 4); y++) {
+    reader.skip(count * sizeof(Item));
+
+}
 
-        if (y >= 0) {
-            FX::seekDataArray(FX::readIndexedUInt24(Levels::Level_BG, gamePlay.level), y, offset, this->width);
+void deserialize(SaveReader &reader, GamePlay &gamePlay, Prince &prince) {
 
-            for (uint8_t x = 0; x < 22; x++) {
+    this->width = reader.readUInt8();
+    this->height = reader.readUInt8();
+    this->xLoc = reader.readUInt8();
+    this->yLoc = reader.readUInt8();
+    this->yOffset = reader.readUInt8();
+    this->yOffsetDir = static_cast<Direction>(reader.readUInt8());
+    BackgroundCache::invalidate();
+    this->invalidateVisibleItems();
+    reader.readBytes(&this->flash, sizeof(Flash));
+    reader.readBytes(&this->sign, sizeof(Sign));
 
-                if (x >= 6 || offset) {
-                    bg[y - this->yLoc + 1][x] = static_cast<int8_t>(FX::readPendingUInt8());
-                }
+    uint8_t changed[(Constants::Items_Count + 7) / 8];
+    reader.readBytes(changed, sizeof(changed));
 
-            }
+    if (reader.hasFailed()) return;
+
+    this->loadItems(gamePlay.level, prince);
 
-            FX::readEnd();
+    for (uint8_t i = 0; i < Constants::Items_Count; i++) {
+
+        if (changed[i / 8] & (1 << (i % 8))) {
+            reader.readBytes(&this->items[i], sizeof(Item));
         }
 
     }
 
+}
+
+void loadMap(GamePlay &gamePlay) {
+
+    FX::setTraceTag(FxTraceTagLevel);
+
+    // Both layers are stored row-major, width x height, so each is a single
+    // run in FX.  Rooms are views into these from here on ..
+
+    uint16_t size = this->width * this->height;
+
+    if (size > Constants::Level_Tiles_Max) {
+        size = Constants::Level_Tiles_Max;
+    }
+
+    FX::Reader reader(FX::readIndexedUInt24(Levels::Level_BG, gamePlay.level));
+    reader.readBytes((uint8_t*)bg, size);
+
+    reader.seek(FX::readIndexedUInt24(Levels::level_FG, gamePlay.level));
+    reader.readBytes((uint8_t*)fg, size);
+
+    BackgroundCache::invalidate();
+
+    #if defined(DEBUG) && defined(DEBUG_LEVEL_LOAD_MAP)
+    printMap();
+    #endif
+
+    this->hintNeighbouringRooms();
+
+    FX::setTraceTag(FxTraceTagLogic);
+
+}
+
+void hintNeighbouringRooms() {
+
+    // Tile frames that only appear in the rooms left, right, above and below
+    // this one, so a screen flip finds them already cached ..
+
+    static const int8_t neighbours[4][2] = { { -10, 0 }, { 10, 0 }, { 0, -3 }, { 0, 3 } };
+
+    uint8_t onScreen[16];
+    uint8_t hinted[16];
+
+    memset(onScreen, 0, sizeof(onScreen));
+    memset(hinted, 0, sizeof(hinted));
 
-    // Foreground ..
+    for (int8_t y = -1; y < 3; y++) {
 
-    for (uint8_t x = 0; x < 5 * 22; x++) {
+        for (int8_t x = 0; x < 10; x++) {
 
-        *(&fg[0][0] + x) = TILE_FG_WALL_1;
+            int8_t bgTile = this->getMapTile(Layer::Background, this->xLoc + x, this->yLoc + y);
+            int8_t fgTile = this->getMapTile(Layer::Foreground, this->xLoc + x, this->yLoc + y);
+
+            if (bgTile >= 0) onScreen[bgTile >> 3] |= (1 << (bgTile & 7));
+            if (fgTile >= 0) onScreen[fgTile >> 3] |= (1 << (fgTile & 7));
+
+        }
 
     }
 
-    for (int8_t y = this->yLoc - 1; y < (int8_t)(this->yLoc + 4); y++) {
+    for (uint8_t n = 0; n < 4; n++) {
+
+        int16_t roomX = this->xLoc + neighbours[n][0];
+        int16_t roomY = this->yLoc + neighbours[n][1];
+
+        // getMapTile() wraps a column past the right edge onto the next row,
+        // so skip rooms that fall outside the map ..
+
+        if (roomX < 0 || roomX + 10 > this->width || roomY < 0 || roomY + 3 > this->height) continue;
+
+        for (int8_t y = 0; y < 3; y++) {
+
+            for (int8_t x = 0; x < 10; x++) {
 
-        if (y >= 0) {
+                for (uint8_t layer = 0; layer < 2; layer++) {
 
-            FX::seekDataArray(FX::readIndexedUInt24(Levels::level_FG, gamePlay.level), y, offset, this->width);
+                    int8_t tile = this->getMapTile(layer == 0 ? Layer::Background : Layer::Foreground, roomX + x, roomY + y);
 
-            for (uint8_t x = 0; x < 22; x++) {
+                    if (tile < 0 || tile > 123) continue;
+                    if (layer == 1 && (tile == Constants::Tile_CollapsedTile_Full || tile == Constants::Tile_CollapsedTile_Half)) continue;
+
+                    uint8_t bit = (1 << (tile & 7));
+
+                    if ((onScreen[tile >> 3] | hinted[tile >> 3]) & bit) continue;
+
+                    hinted[tile >> 3] |= bit;
+                    FX::hintBitmapFrame(Images::Tiles_Dungeon, tile, dbmMasked, FX::hintLow);
 
-                if (x >= 6 || offset) {
-                    fg[y - this->yLoc + 1][x] = static_cast<int8_t>(FX::readPendingUInt8());
                 }
+
             }
 
-            FX::readEnd();
         }
 
     }
 
-    #if defined(DEBUG) && defined(DEBUG_LEVEL_LOAD_MAP)
-    printMap();
-    #endif
-
 }
\ No newline at end of file
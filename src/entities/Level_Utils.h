@@ -17,7 +17,7 @@ void printMap() {
 
         for (uint8_t x = 0; x < 22; x++) {
 
-            DEBUG_PRINT(bg[y][x]);
+            DEBUG_PRINT(this->getMapTile(Layer::Background, this->xLoc + x - 6, this->yLoc + y - 1));
             DEBUG_PRINT(" ");
 
             if (x == 2 || x == 12) {
@@ -37,7 +37,7 @@ void printMap() {
 
         for (uint8_t x = 0; x < 16; x++) {
 
-            DEBUG_PRINT(fg[y][x]);
+            DEBUG_PRINT(this->getMapTile(Layer::Foreground, this->xLoc + x - 6, this->yLoc + y - 1));
             DEBUG_PRINT(" ");
 
             if (x == 2 || x == 12) {
@@ -91,6 +91,34 @@ class Prince : public BaseEntity, public BaseStack {
 
         }
 
+        static constexpr uint8_t SaveSize = BaseEntity::SaveSize + 4;
+
+        void serialize(SaveWriter &writer) {
+
+            BaseEntity::serialize(writer);
+
+            writer.writeUInt8(this->hangingCounter);
+            writer.writeUInt8(this->crouchingCounter);
+            writer.writeUInt8(this->falling);
+            writer.writeUInt8((this->sword ? 1 : 0) | (this->potionFloat ? 2 : 0) | (this->ignoreWallCollisions ? 4 : 0));
+
+        }
+
+        void deserialize(SaveReader &reader) {
+
+            BaseEntity::deserialize(reader);
+
+            this->hangingCounter = reader.readUInt8();
+            this->crouchingCounter = reader.readUInt8();
+            this->falling = reader.readUInt8();
+
+            uint8_t flags = reader.readUInt8();
+            this->sword = (flags & 1) != 0;
+            this->potionFloat = (flags & 2) != 0;
+            this->ignoreWallCollisions = (flags & 4) != 0;
+
+        }
+
         bool isSwordDrawn() {
 
             switch (this->stance) {
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <lib/Arduboy2.h>
+#include "Constants.h"
+
+// The room's background tiles and collapsed floor tiles, as render() drew
+// them onto a blank screen.  The layer is YOffset_Max rows taller than the
+// screen, so it holds the room at every yOffset a scroll between tile rows
+// passes through; row r of the screen is row r + yOffset of the layer.
+// It only changes when the room or the level map does, and Level calls
+// invalidate() whenever one of those moves.  Until then render() copies
+// the layer into the screen instead of drawing 40 tiles at a sub-byte
+// shift.  Torches flicker, so they are kept out of the layer and drawn
+// over it every frame ..
+
+struct BackgroundCache {
+
+    struct Stats {
+        uint32_t restores;                      // Frames served by a copy.
+        uint32_t shifted;                       // .. of which needed a bit shift.
+        uint32_t rebuilds;                      // Frames that redrew the tiles.
+        uint32_t direct;                        // yOffset past the layer, drawn directly.
+    };
+
+    struct Torch {
+        int8_t x;                               // Tile column on screen.
+        int8_t y;                               // Tile row, as passed to getTile().
+    };
+
+    static constexpr uint8_t YOffset_Max = 32;
+    static constexpr uint16_t Screen_Size = (WIDTH * HEIGHT) / 8;
+    static constexpr uint16_t Layer_Size = (WIDTH * (HEIGHT + YOffset_Max)) / 8;
+    static constexpr uint8_t Torches_Max = 40;
+
+    static uint8_t layer[Layer_Size];
+    static Torch torches[Torches_Max];
+    static uint8_t torchCount;
+    static bool valid;
+    static Stats stats;
+
+
+    static bool isValid()                       { return valid; }
+    static void invalidate()                    { valid = false; }
+
+    static uint8_t getTorchCount()              { return torchCount; }
+    static const Torch &getTorch(uint8_t idx)   { return torches[idx]; }
+
+    static void getStats(Stats &out)            { out = stats; }
+    static void resetStats()                    { stats = { 0, 0, 0, 0 }; }
+    static void countDirect()                   { stats.direct++; }
+
+
+    // Start recording a new layer; torches are listed as the tiles are drawn ..
+
+    static void begin() {
+
+        torchCount = 0;
+
+    }
+
+    static void addTorch(int8_t x, int8_t y) {
+
+        if (torchCount < Torches_Max) {
+            torches[torchCount++] = { x, y };
+        }
+
+    }
+
+    // The layer is built from two screens: the room drawn at yOffset 0, and
+    // at YOffset_Max for the rows below it ..
+
+    static void storeTop(const uint8_t *screen) {
+
+        memcpy(layer, screen, Screen_Size);
+
+    }
+
+    static void storeBottom(const uint8_t *screen) {
+
+        constexpr uint16_t Bottom_Size = (WIDTH * YOffset_Max) / 8;
+
+        memcpy(layer + Screen_Size, screen + Screen_Size - Bottom_Size, Bottom_Size);
+        valid = true;
+        stats.rebuilds++;
+
+    }
+
+    // Copy the screen-sized window starting yOffset rows down.  Within a page
+    // each byte is a column of eight rows, so an unaligned window takes the
+    // low rows of one page and the high rows of the next, four columns per
+    // word ..
+
+    static void restore(uint8_t *screen, uint8_t yOffset) {
+
+        const uint8_t *src = layer + (yOffset >> 3) * WIDTH;
+        const uint8_t shift = yOffset & 7;
+
+        stats.restores++;
+
+        if (shift == 0) {
+            memcpy(screen, src, Screen_Size);
+            return;
+        }
+
+        const uint32_t low = 0x01010101u * (0xFFu >> shift);
+
+        for (uint16_t i = 0; i < Screen_Size; i += sizeof(uint32_t)) {
+
+            uint32_t upper, lower;
+            memcpy(&upper, src + i, sizeof(upper));
+            memcpy(&lower, src + i + WIDTH, sizeof(lower));
+
+            const uint32_t word = ((upper >> shift) & low) | ((lower << (8 - shift)) & ~low);
+            memcpy(screen + i, &word, sizeof(word));
+
+        }
+
+        stats.shifted++;
+
+    }
+
+};
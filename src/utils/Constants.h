@@ -1536,6 +1536,7 @@ namespace Constants {
     constexpr uint8_t Item_ExitDoor = 0;
     constexpr uint8_t Item_LoveHeart = 1;           // Inside dynamic range as only used in cut scenes..
     constexpr uint8_t Items_Count = 49;
+    constexpr uint16_t Level_Tiles_Max = 80 * 21;   // Largest level (12), tiles per layer ..
    
     constexpr uint8_t FrameRate = 45;
     constexpr uint8_t Animation_NumberOfFrames = 2;
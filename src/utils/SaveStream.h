@@ -0,0 +1,127 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+// Byte streams used by the Cookie serializer.  Values are little-endian and
+// a stream that runs past its buffer stops writing / reads zeros and is
+// flagged as failed, so a short or truncated save can never overrun.
+
+class SaveWriter {
+
+    private:
+
+        uint8_t *buffer;
+        uint16_t capacity;
+        uint16_t size = 0;
+        bool failed = false;
+
+    public:
+
+        SaveWriter(uint8_t *buffer, uint16_t capacity) : buffer(buffer), capacity(capacity) {}
+
+        uint16_t getSize()                          { return this->size; }
+        bool hasFailed()                            { return this->failed; }
+
+        uint8_t *reserve(uint16_t length) {
+
+            if (this->failed || this->capacity - this->size < length) {
+                this->failed = true;
+                return nullptr;
+            }
+
+            uint8_t *ptr = this->buffer + this->size;
+            this->size = this->size + length;
+            return ptr;
+
+        }
+
+        void writeUInt8(uint8_t val) {
+
+            uint8_t *ptr = this->reserve(1);
+            if (ptr) ptr[0] = val;
+
+        }
+
+        void writeUInt16(uint16_t val) {
+
+            uint8_t *ptr = this->reserve(2);
+
+            if (ptr) {
+                ptr[0] = static_cast<uint8_t>(val);
+                ptr[1] = static_cast<uint8_t>(val >> 8);
+            }
+
+        }
+
+        void writeInt16(int16_t val)                { this->writeUInt16(static_cast<uint16_t>(val)); }
+
+        void writeBytes(const void *data, uint16_t length) {
+
+            uint8_t *ptr = this->reserve(length);
+            if (ptr) memcpy(ptr, data, length);
+
+        }
+
+};
+
+class SaveReader {
+
+    private:
+
+        const uint8_t *buffer;
+        uint16_t size;
+        uint16_t pos = 0;
+        bool failed = false;
+
+    public:
+
+        SaveReader(const uint8_t *buffer, uint16_t size) : buffer(buffer), size(size) {}
+
+        bool hasFailed()                            { return this->failed; }
+        bool atEnd()                                { return this->pos == this->size; }
+
+        const uint8_t *take(uint16_t length) {
+
+            if (this->failed || this->size - this->pos < length) {
+                this->failed = true;
+                return nullptr;
+            }
+
+            const uint8_t *ptr = this->buffer + this->pos;
+            this->pos = this->pos + length;
+            return ptr;
+
+        }
+
+        uint8_t readUInt8() {
+
+            const uint8_t *ptr = this->take(1);
+            return ptr ? ptr[0] : 0;
+
+        }
+
+        uint16_t readUInt16() {
+
+            const uint8_t *ptr = this->take(2);
+            return ptr ? static_cast<uint16_t>(ptr[0] | (ptr[1] << 8)) : 0;
+
+        }
+
+        int16_t readInt16()                         { return static_cast<int16_t>(this->readUInt16()); }
+        void skip(uint16_t length)                  { this->take(length); }
+
+        void readBytes(void *data, uint16_t length) {
+
+            const uint8_t *ptr = this->take(length);
+
+            if (ptr) {
+                memcpy(data, ptr, length);
+            }
+            else {
+                memset(data, 0, length);
+            }
+
+        }
+
+};
@@ -0,0 +1,199 @@
+#pragma once
+
+#include <lib/Arduboy2.h>
+#include <lib/ArduboyFX.h>
+#include "Constants.h"
+#include "Enums.h"
+#include "../../fxdata/fxdata.h"
+
+// RAM copies of the FX tables that movement and rendering look up every
+// frame.  load() reads them once from setup(), after which a lookup is an
+// array index instead of an FX seek.  An index outside a table (the game
+// does not make any) is still read from FX, so results never change ..
+
+struct StanceTables {
+
+    struct Stats {
+        uint32_t loadMicros;                    // Time taken by load().
+        uint16_t loadBytes;                     // RAM held by the tables.
+        uint32_t lookups;                       // Served from RAM since resetStats().
+        uint32_t misses;                        // Fell back to FX.
+    };
+
+
+    // Each table runs up to the one after it in fxdata.bin ..
+
+    static constexpr uint16_t ImageXRef_Size = Constants::Stance_XYOffsetsFX - Constants::StanceToImageXRefFX;
+    static constexpr uint16_t Offsets_Size = Constants::VertAdjustments - Constants::Stance_XYOffsetsFX;
+    static constexpr uint16_t VertAdjustments_Size = Constants::Prince_ImageDetails - Constants::VertAdjustments;
+    static constexpr uint16_t ImageDetails_Size = splashScreen_Frame - Constants::Prince_ImageDetails;
+    static constexpr uint8_t RunningJumps_Count = (StandingJumpStances - RunningJumpStances) / 16;
+    static constexpr uint8_t StandingJumps_Count = static_cast<uint8_t>(StandingJumpResult::GrabLedge_40) + 1;
+    static constexpr uint8_t Jump_Length = 8;  // Two sequences of three, collision, hanging counter.
+
+    static uint8_t imageXRef[ImageXRef_Size];
+    static int8_t offsets[Offsets_Size];
+    static uint8_t vertAdjustments[VertAdjustments_Size];
+    static uint8_t imageDetails[ImageDetails_Size];
+    static uint16_t runningJumps[RunningJumps_Count][Jump_Length];
+    static uint16_t standingJumps[StandingJumps_Count][Jump_Length];
+    static uint16_t jumpFromFX[Jump_Length];
+    static Stats stats;
+
+
+    static void load() {
+
+        uint32_t start = micros();
+        FX::Reader reader;
+
+        reader.seek(Constants::StanceToImageXRefFX);
+        reader.readBytes(imageXRef, sizeof(imageXRef));
+
+        reader.seek(Constants::Stance_XYOffsetsFX);
+        reader.readBytes((uint8_t*)offsets, sizeof(offsets));
+
+        reader.seek(Constants::VertAdjustments);
+        reader.readBytes(vertAdjustments, sizeof(vertAdjustments));
+
+        reader.seek(Constants::Prince_ImageDetails);
+        reader.readBytes(imageDetails, sizeof(imageDetails));
+
+        reader.seek(RunningJumpStances);
+
+        for (uint8_t i = 0; i < RunningJumps_Count; i++) {
+            for (uint8_t j = 0; j < Jump_Length; j++) {
+                runningJumps[i][j] = reader.readUInt16();
+            }
+        }
+
+        reader.seek(StandingJumpStances);
+
+        for (uint8_t i = 0; i < StandingJumps_Count; i++) {
+            for (uint8_t j = 0; j < Jump_Length; j++) {
+                standingJumps[i][j] = reader.readUInt16();
+            }
+        }
+
+        stats.loadMicros = micros() - start;
+        stats.loadBytes = sizeof(imageXRef) + sizeof(offsets) + sizeof(vertAdjustments) + sizeof(imageDetails) + sizeof(runningJumps) + sizeof(standingJumps);
+
+    }
+
+    static void getStats(Stats &out)                { out = stats; }
+
+    static void resetStats() {
+
+        stats.lookups = 0;
+        stats.misses = 0;
+
+    }
+
+
+    static uint8_t getImageIndex(uint16_t stance) {
+
+        if (stance < ImageXRef_Size) {
+            stats.lookups++;
+            return imageXRef[stance];
+        }
+
+        stats.misses++;
+        FX::seekData(Constants::StanceToImageXRefFX + stance);
+        return FX::readEnd();
+
+    }
+
+    // X and Y offset of a stance, as stored (before direction is applied) ..
+
+    static void getOffsets(int16_t stance, int8_t &x, int8_t &y) {
+
+        int16_t idx = (stance - 1) * 2;
+
+        if (idx >= 0 && idx + 1 < Offsets_Size) {
+            stats.lookups++;
+            x = offsets[idx];
+            y = offsets[idx + 1];
+            return;
+        }
+
+        stats.misses++;
+        FX::seekData(Constants::Stance_XYOffsetsFX + idx);
+        x = static_cast<int8_t>(FX::readPendingUInt8());
+        y = static_cast<int8_t>(FX::readEnd());
+
+    }
+
+    static uint8_t getVertAdjustment(uint16_t idx) {
+
+        if (idx < VertAdjustments_Size) {
+            stats.lookups++;
+            return vertAdjustments[idx];
+        }
+
+        stats.misses++;
+        FX::seekData(Constants::VertAdjustments + idx);
+        return FX::readEnd();
+
+    }
+
+    // Reach, toe and heel of a Prince image, as stored ..
+
+    static void getImageDetails(uint8_t imageIndex, uint8_t &reach, uint8_t &toe, uint8_t &heel) {
+
+        int16_t idx = (imageIndex - 1) * 3;
+
+        if (idx >= 0 && idx + 2 < ImageDetails_Size) {
+            stats.lookups++;
+            reach = imageDetails[idx];
+            toe = imageDetails[idx + 1];
+            heel = imageDetails[idx + 2];
+            return;
+        }
+
+        stats.misses++;
+        FX::seekData(static_cast<uint24_t>(Constants::Prince_ImageDetails + idx));
+        reach = FX::readPendingUInt8();
+        toe = FX::readPendingUInt8();
+        heel = FX::readEnd();
+
+    }
+
+    static const uint16_t *getRunningJump(RunningJumpResult result) {
+
+        uint8_t idx = static_cast<uint8_t>(result);
+
+        if (idx < RunningJumps_Count) {
+            stats.lookups++;
+            return runningJumps[idx];
+        }
+
+        return readJump(RunningJumpStances + static_cast<uint24_t>(idx * 16));
+
+    }
+
+    static const uint16_t *getStandingJump(StandingJumpResult result) {
+
+        uint8_t idx = static_cast<uint8_t>(result);
+
+        if (idx < StandingJumps_Count) {
+            stats.lookups++;
+            return standingJumps[idx];
+        }
+
+        return readJump(StandingJumpStances + static_cast<uint24_t>(idx * 16));
+
+    }
+
+    static const uint16_t *readJump(uint24_t address) {
+
+        stats.misses++;
+        FX::Reader reader(address);
+
+        for (uint8_t j = 0; j < Jump_Length; j++) {
+            jumpFromFX[j] = reader.readUInt16();
+        }
+
+        return jumpFromFX;
+
+    }
+
+};
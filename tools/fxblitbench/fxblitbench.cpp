@@ -0,0 +1,177 @@
+// Host microbenchmark for the FX::drawBitmap row kernels (lib/include/FxBlit.h).
+//
+// Build (host):
+//   c++ -std=c++17 -O2 -o fxblitbench tools/fxblitbench/fxblitbench.cpp
+//
+// Usage:
+//   fxblitbench [-n iterations]
+//
+// Times the per-column cost of the tile path (12x31 dbmNormal, as
+// Images::Tiles_Dungeon) and the prince path (36x36 dbmMasked, as
+// Images::Prince_Left) at aligned and shifted y. Each case is run through
+// the reference loop that tests the mode bits per column (drawBitmap before
+// the kernels), the runtime-mode kernel, and the kernel fx_blit_pick()
+// returns. Every kernel is checked against the reference first.
+//
+// Host figures only rank the variants; the absolute cost on the Flipper's
+// Cortex-M4 is several times higher.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "../../lib/include/FxBlit.h"
+
+namespace {
+
+constexpr int kWidth = 128;
+constexpr int kRows = 8;
+
+// The per-column loop drawBitmap used before the row kernels.
+void referenceRow(const FxBlitRow& row, uint8_t mode) {
+    const uint8_t yshift = (uint8_t)(1u << row.shift);
+    uint16_t src = 0;
+    for(uint8_t c = 0; c < row.count; c++) {
+        uint8_t bitmapbyte = row.src[src++];
+        if(mode & FX_BLIT_REVERSE_BLACK) bitmapbyte ^= row.rowmask;
+
+        uint8_t maskbyte = row.rowmask;
+        if(mode & FX_BLIT_WHITE_BLACK) maskbyte = bitmapbyte;
+        if(mode & FX_BLIT_BLACK) bitmapbyte = 0;
+
+        const uint16_t bitmap = (uint16_t)bitmapbyte * (uint16_t)yshift;
+
+        if(mode & FX_BLIT_MASKED) {
+            uint8_t tmp = row.src[src++];
+            if((mode & FX_BLIT_WHITE_BLACK) == 0u) maskbyte = tmp;
+        }
+
+        const uint16_t mask = (uint16_t)maskbyte * (uint16_t)yshift;
+        const uint8_t col = (mode & FX_BLIT_FLIP) ? (uint8_t)(row.count - 1 - c) : c;
+
+        if(row.dst0) {
+            uint8_t display = row.dst0[col];
+            uint8_t pixels = (uint8_t)(bitmap & 0xFFu);
+            if((mode & FX_BLIT_INVERT) == 0u) pixels ^= display;
+            pixels &= (uint8_t)(mask & 0xFFu);
+            pixels ^= display;
+            row.dst0[col] = pixels;
+        }
+        if(row.dst1) {
+            uint8_t display = row.dst1[col];
+            uint8_t pixels = (uint8_t)(bitmap >> 8);
+            if((mode & FX_BLIT_INVERT) == 0u) pixels ^= display;
+            pixels &= (uint8_t)(mask >> 8);
+            pixels ^= display;
+            row.dst1[col] = pixels;
+        }
+    }
+}
+
+struct Case {
+    const char* name;
+    uint8_t w;
+    uint8_t h;
+    uint8_t mode;
+    uint8_t y;
+};
+
+// Draws one w x h frame at (16, y) with `fn`, row by row as drawBitmap does.
+void drawFrame(const Case& k, const uint8_t* image, uint8_t* screen, FxBlitRowFn fn) {
+    const uint8_t shift = k.y & 7;
+    const uint8_t row_bytes = (k.mode & FX_BLIT_MASKED) ? (uint8_t)(k.w * 2) : k.w;
+    const uint8_t lastmask = (k.h & 7) ? (uint8_t)((1u << (k.h & 7)) - 1u) : 0xFFu;
+    int displayrow = k.y >> 3;
+    for(int left = k.h, r = 0; left > 0 && displayrow < kRows; left -= 8, r++, displayrow++) {
+        FxBlitRow row;
+        row.src = image + r * row_bytes;
+        row.dst0 = screen + displayrow * kWidth + 16;
+        row.dst1 = (shift && displayrow + 1 < kRows) ? screen + (displayrow + 1) * kWidth + 16 : nullptr;
+        row.count = k.w;
+        row.rowmask = (left < 8) ? lastmask : 0xFFu;
+        row.shift = shift;
+        fn(row, k.mode);
+    }
+}
+
+double nsPerColumn(const Case& k, const uint8_t* image, FxBlitRowFn fn, int iters, uint32_t& sink) {
+    static uint8_t screen[kWidth * kRows];
+    memset(screen, 0x5A, sizeof(screen));
+    const int columns = k.w * ((k.h + 7) / 8);
+    double best = 1e30;
+    for(int rep = 0; rep < 5; rep++) {
+        const auto t0 = std::chrono::steady_clock::now();
+        for(int i = 0; i < iters; i++) {
+            drawFrame(k, image, screen, fn);
+            __asm__ __volatile__("" : : "r"(screen) : "memory");
+        }
+        const auto t1 = std::chrono::steady_clock::now();
+        const double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+        if(ns < best) best = ns;
+    }
+    sink += screen[k.y / 8 * kWidth + 16];
+    return best / ((double)iters * columns);
+}
+
+bool sameOutput(const Case& k, const uint8_t* image, FxBlitRowFn fn) {
+    uint8_t a[kWidth * kRows];
+    uint8_t b[kWidth * kRows];
+    for(uint8_t mode : {k.mode, (uint8_t)(k.mode | FX_BLIT_FLIP), (uint8_t)(k.mode | FX_BLIT_INVERT)}) {
+        Case c = k;
+        c.mode = mode;
+        for(int i = 0; i < kWidth * kRows; i++)
+            a[i] = b[i] = (uint8_t)(i * 37 + 11);
+        drawFrame(c, image, a, referenceRow);
+        drawFrame(c, image, b, fn == nullptr ? fx_blit_pick(mode, (c.y & 7) != 0) : fn);
+        if(memcmp(a, b, sizeof(a)) != 0) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int iters = 200000;
+    for(int i = 1; i < argc; i++) {
+        if(!strcmp(argv[i], "-n") && i + 1 < argc)
+            iters = atoi(argv[++i]);
+        else {
+            fprintf(stderr, "usage: fxblitbench [-n iterations]\n");
+            return 2;
+        }
+    }
+
+    std::vector<uint8_t> image(36 * 2 * 5);
+    std::mt19937 rng(1);
+    for(uint8_t& b : image)
+        b = (uint8_t)rng();
+
+    const Case cases[] = {
+        {"tile aligned", 12, 31, 0, 8},
+        {"tile shifted", 12, 31, 0, 11},
+        {"prince aligned", 36, 36, FX_BLIT_MASKED, 16},
+        {"prince shifted", 36, 36, FX_BLIT_MASKED, 21},
+    };
+
+    uint32_t sink = 0;
+    printf("%-16s %12s %12s %12s %8s\n", "ns/column", "reference", "runtime", "specialized", "speedup");
+    for(const Case& k : cases) {
+        const bool shifted = (k.y & 7) != 0;
+        const FxBlitRowFn runtime = shifted ? fx_blit_row<FX_BLIT_MODE_RUNTIME, true> :
+                                              fx_blit_row<FX_BLIT_MODE_RUNTIME, false>;
+        const FxBlitRowFn picked = fx_blit_pick(k.mode, shifted);
+        if(!sameOutput(k, image.data(), runtime) || !sameOutput(k, image.data(), nullptr)) {
+            fprintf(stderr, "fxblitbench: %s kernel output differs from the reference\n", k.name);
+            return 1;
+        }
+        const double ref = nsPerColumn(k, image.data(), referenceRow, iters, sink);
+        const double rt = nsPerColumn(k, image.data(), runtime, iters, sink);
+        const double sp = nsPerColumn(k, image.data(), picked, iters, sink);
+        printf("%-16s %12.3f %12.3f %12.3f %7.2fx\n", k.name, ref, rt, sp, ref / sp);
+    }
+    return sink == 0xFFFFFFFFu ? 1 : 0;
+}
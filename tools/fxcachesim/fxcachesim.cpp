@@ -0,0 +1,423 @@
+// Offline replay of an FX access trace (ARDULIB_FX_TRACE) against cache models.
+//
+// Build (host):
+//   c++ -std=c++17 -O2 -o fxcachesim tools/fxcachesim/fxcachesim.cpp
+//
+// Usage:
+//   fxcachesim [-p 512,1024,2048,4096] [-n 8,16,32,64] [-m lru,2q,arc] [-t tag] fxtrace.bin
+//
+// Every record touches the pages covering [addr, addr + len). A miss costs one
+// seek and one page_size read, as in FX::dataLoadPage_. Prefetch is not
+// modelled, so the figures are the demand-miss baseline for a configuration.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../../lib/include/FxTrace.h"
+
+namespace {
+
+struct Access {
+    uint32_t addr;
+    uint32_t len;
+    uint32_t frame;
+    uint8_t kind;
+    uint8_t tag;
+};
+
+// ---------------------------------------------------------------------------
+// Cache models. access() returns true on hit.
+
+class Model {
+public:
+    virtual ~Model() = default;
+    virtual bool access(uint32_t page) = 0;
+};
+
+class LruModel : public Model {
+public:
+    explicit LruModel(size_t capacity) : capacity_(capacity) {}
+
+    bool access(uint32_t page) override {
+        auto it = map_.find(page);
+        if(it != map_.end()) {
+            lru_.splice(lru_.begin(), lru_, it->second);
+            return true;
+        }
+        if(lru_.size() == capacity_) {
+            map_.erase(lru_.back());
+            lru_.pop_back();
+        }
+        lru_.push_front(page);
+        map_[page] = lru_.begin();
+        return false;
+    }
+
+private:
+    size_t capacity_;
+    std::list<uint32_t> lru_;
+    std::unordered_map<uint32_t, std::list<uint32_t>::iterator> map_;
+};
+
+// Full 2Q (Johnson & Shasha): FIFO A1in for first touches, ghost A1out for
+// recently evicted first-touch pages, LRU Am for pages seen twice.
+class TwoQModel : public Model {
+public:
+    explicit TwoQModel(size_t capacity)
+        : capacity_(capacity)
+        , kin_(capacity / 4 ? capacity / 4 : 1)
+        , kout_(capacity / 2 ? capacity / 2 : 1) {}
+
+    bool access(uint32_t page) override {
+        auto it = map_.find(page);
+        if(it != map_.end()) {
+            Entry& e = it->second;
+            if(e.where == Where::Am) {
+                am_.splice(am_.begin(), am_, e.pos);
+                return true;
+            }
+            if(e.where == Where::A1in) return true;
+
+            // Ghost hit in A1out: promote to Am.
+            a1out_.erase(e.pos);
+            reclaim();
+            am_.push_front(page);
+            e.where = Where::Am;
+            e.pos = am_.begin();
+            return false;
+        }
+
+        reclaim();
+        a1in_.push_front(page);
+        map_[page] = Entry{Where::A1in, a1in_.begin()};
+        return false;
+    }
+
+private:
+    enum class Where : uint8_t { A1in, A1out, Am };
+    struct Entry {
+        Where where;
+        std::list<uint32_t>::iterator pos;
+    };
+
+    void reclaim() {
+        if(a1in_.size() + am_.size() < capacity_) return;
+        if(a1in_.size() > kin_ || am_.empty()) {
+            const uint32_t victim = a1in_.back();
+            a1in_.pop_back();
+            a1out_.push_front(victim);
+            map_[victim] = Entry{Where::A1out, a1out_.begin()};
+            if(a1out_.size() > kout_) {
+                map_.erase(a1out_.back());
+                a1out_.pop_back();
+            }
+        } else {
+            map_.erase(am_.back());
+            am_.pop_back();
+        }
+    }
+
+    size_t capacity_;
+    size_t kin_;
+    size_t kout_;
+    std::list<uint32_t> a1in_;
+    std::list<uint32_t> a1out_;
+    std::list<uint32_t> am_;
+    std::unordered_map<uint32_t, Entry> map_;
+};
+
+// ARC (Megiddo & Modha).
+class ArcModel : public Model {
+public:
+    explicit ArcModel(size_t capacity) : c_(capacity) {}
+
+    bool access(uint32_t page) override {
+        auto it = map_.find(page);
+        if(it != map_.end()) {
+            Entry& e = it->second;
+            switch(e.where) {
+            case Where::T1:
+            case Where::T2:
+                lists_[(int)e.where].erase(e.pos);
+                insert(Where::T2, page, e);
+                return true;
+            case Where::B1: {
+                const size_t d = std::max<size_t>(1, size(Where::B2) / std::max<size_t>(1, size(Where::B1)));
+                p_ = std::min(c_, p_ + d);
+                replace(false);
+                lists_[(int)Where::B1].erase(e.pos);
+                insert(Where::T2, page, e);
+                return false;
+            }
+            case Where::B2: {
+                const size_t d = std::max<size_t>(1, size(Where::B1) / std::max<size_t>(1, size(Where::B2)));
+                p_ = (p_ > d) ? p_ - d : 0;
+                replace(true);
+                lists_[(int)Where::B2].erase(e.pos);
+                insert(Where::T2, page, e);
+                return false;
+            }
+            }
+        }
+
+        const size_t l1 = size(Where::T1) + size(Where::B1);
+        const size_t total = l1 + size(Where::T2) + size(Where::B2);
+        if(l1 == c_) {
+            if(size(Where::T1) < c_) {
+                dropLru(Where::B1);
+                replace(false);
+            } else {
+                dropLru(Where::T1);
+            }
+        } else if(l1 < c_ && total >= c_) {
+            if(total == 2 * c_) dropLru(Where::B2);
+            replace(false);
+        }
+        Entry e{};
+        insert(Where::T1, page, e);
+        map_[page] = e;
+        return false;
+    }
+
+private:
+    enum class Where : uint8_t { T1 = 0, T2 = 1, B1 = 2, B2 = 3 };
+    struct Entry {
+        Where where;
+        std::list<uint32_t>::iterator pos;
+    };
+
+    size_t size(Where w) const {
+        return lists_[(int)w].size();
+    }
+
+    void insert(Where w, uint32_t page, Entry& e) {
+        lists_[(int)w].push_front(page);
+        e.where = w;
+        e.pos = lists_[(int)w].begin();
+    }
+
+    void dropLru(Where w) {
+        auto& l = lists_[(int)w];
+        if(l.empty()) return;
+        map_.erase(l.back());
+        l.pop_back();
+    }
+
+    void moveLru(Where from, Where to) {
+        auto& l = lists_[(int)from];
+        const uint32_t page = l.back();
+        l.pop_back();
+        insert(to, page, map_[page]);
+    }
+
+    void replace(bool in_b2) {
+        const size_t t1 = size(Where::T1);
+        if(t1 > 0 && (t1 > p_ || (in_b2 && t1 == p_)))
+            moveLru(Where::T1, Where::B1);
+        else if(size(Where::T2) > 0)
+            moveLru(Where::T2, Where::B2);
+        else if(t1 > 0)
+            moveLru(Where::T1, Where::B1);
+    }
+
+    size_t c_;
+    size_t p_ = 0;
+    std::list<uint32_t> lists_[4];
+    std::unordered_map<uint32_t, Entry> map_;
+};
+
+std::unique_ptr<Model> makeModel(const std::string& name, size_t pages) {
+    if(name == "lru") return std::make_unique<LruModel>(pages);
+    if(name == "2q") return std::make_unique<TwoQModel>(pages);
+    if(name == "arc") return std::make_unique<ArcModel>(pages);
+    return nullptr;
+}
+
+// ---------------------------------------------------------------------------
+
+bool loadTrace(const char* path, std::vector<Access>& out, uint16_t& page_size) {
+    FILE* f = fopen(path, "rb");
+    if(!f) {
+        fprintf(stderr, "fxcachesim: cannot open %s\n", path);
+        return false;
+    }
+
+    uint8_t hdr[FX_TRACE_HEADER_SIZE];
+    if(fread(hdr, 1, sizeof(hdr), f) != sizeof(hdr) || memcmp(hdr, FX_TRACE_MAGIC, 4) != 0 ||
+       hdr[4] != FX_TRACE_VERSION || hdr[5] != FX_TRACE_RECORD_SIZE) {
+        fprintf(stderr, "fxcachesim: %s is not an FX trace (v%d)\n", path, FX_TRACE_VERSION);
+        fclose(f);
+        return false;
+    }
+    page_size = (uint16_t)(hdr[6] | (hdr[7] << 8));
+
+    uint8_t r[FX_TRACE_RECORD_SIZE];
+    uint32_t epoch = 0;
+    uint16_t last = 0;
+    while(fread(r, 1, sizeof(r), f) == sizeof(r)) {
+        const uint16_t frame = (uint16_t)(r[5] | (r[6] << 8));
+        if(frame < last) epoch += 0x10000u;
+        last = frame;
+
+        Access a;
+        a.addr = (uint32_t)r[0] | ((uint32_t)r[1] << 8) | ((uint32_t)r[2] << 16);
+        a.len = (uint32_t)r[3] | ((uint32_t)r[4] << 8);
+        a.frame = epoch + frame;
+        a.kind = r[7];
+        a.tag = r[8];
+        out.push_back(a);
+    }
+    fclose(f);
+    return true;
+}
+
+std::vector<uint32_t> parseList(const char* s) {
+    std::vector<uint32_t> v;
+    while(*s) {
+        v.push_back((uint32_t)strtoul(s, const_cast<char**>(&s), 10));
+        if(*s == ',') s++;
+        else if(*s) break;
+    }
+    return v;
+}
+
+std::vector<std::string> parseNames(const char* s) {
+    std::vector<std::string> v;
+    std::string cur;
+    for(; *s; s++) {
+        if(*s == ',') {
+            if(!cur.empty()) v.push_back(cur);
+            cur.clear();
+        } else {
+            cur += *s;
+        }
+    }
+    if(!cur.empty()) v.push_back(cur);
+    return v;
+}
+
+struct Result {
+    uint64_t accesses = 0;
+    uint64_t hits = 0;
+    uint64_t bytes = 0;
+    uint64_t seeks = 0;
+    uint64_t worst_bytes = 0;
+    uint32_t worst_frame = 0;
+};
+
+Result replay(const std::vector<Access>& trace, Model& model, uint32_t page_size, int tag) {
+    Result res;
+    uint32_t frame = trace.empty() ? 0 : trace.front().frame;
+    uint64_t frame_bytes = 0;
+
+    auto closeFrame = [&]() {
+        if(frame_bytes > res.worst_bytes) {
+            res.worst_bytes = frame_bytes;
+            res.worst_frame = frame;
+        }
+        frame_bytes = 0;
+    };
+
+    for(const Access& a : trace) {
+        if(a.frame != frame) {
+            closeFrame();
+            frame = a.frame;
+        }
+        if(tag >= 0 && a.tag != tag) continue;
+
+        const uint32_t first = a.addr / page_size;
+        const uint32_t last = (a.addr + a.len - 1u) / page_size;
+        for(uint32_t p = first; p <= last; p++) {
+            res.accesses++;
+            if(model.access(p)) {
+                res.hits++;
+            } else {
+                res.seeks++;
+                res.bytes += page_size;
+                frame_bytes += page_size;
+            }
+        }
+    }
+    closeFrame();
+    return res;
+}
+
+void usage() {
+    fprintf(stderr,
+            "usage: fxcachesim [-p sizes] [-n pages] [-m lru,2q,arc] [-t tag] fxtrace.bin\n"
+            "  -p  page sizes in bytes      (default 512,1024,2048,4096)\n"
+            "  -n  cache page counts        (default 8,16,32,64)\n"
+            "  -m  models                   (default lru,2q,arc)\n"
+            "  -t  only replay this tag     (FxTraceTag value)\n");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::vector<uint32_t> sizes = {512, 1024, 2048, 4096};
+    std::vector<uint32_t> counts = {8, 16, 32, 64};
+    std::vector<std::string> models = {"lru", "2q", "arc"};
+    int tag = -1;
+    const char* path = nullptr;
+
+    for(int i = 1; i < argc; i++) {
+        const bool has_arg = (i + 1 < argc);
+        if(!strcmp(argv[i], "-p") && has_arg)
+            sizes = parseList(argv[++i]);
+        else if(!strcmp(argv[i], "-n") && has_arg)
+            counts = parseList(argv[++i]);
+        else if(!strcmp(argv[i], "-m") && has_arg)
+            models = parseNames(argv[++i]);
+        else if(!strcmp(argv[i], "-t") && has_arg)
+            tag = atoi(argv[++i]);
+        else if(argv[i][0] == '-') {
+            usage();
+            return 2;
+        } else
+            path = argv[i];
+    }
+    if(!path) {
+        usage();
+        return 2;
+    }
+
+    std::vector<Access> trace;
+    uint16_t traced_page_size = 0;
+    if(!loadTrace(path, trace, traced_page_size)) return 1;
+
+    const uint32_t frames = trace.empty() ? 0 : (trace.back().frame - trace.front().frame + 1u);
+    printf("%s: %zu reads over %u frames (recorded with %u-byte pages)\n\n",
+           path, trace.size(), frames, traced_page_size);
+    printf("%-5s %6s %5s %8s %10s %12s %11s %12s %8s\n",
+           "model", "page", "pages", "hit%", "misses", "bytes read", "seeks/frame",
+           "worst frame", "at");
+
+    for(const std::string& m : models) {
+        for(uint32_t ps : sizes) {
+            if(ps == 0) continue;
+            for(uint32_t n : counts) {
+                std::unique_ptr<Model> model = makeModel(m, n);
+                if(!model) {
+                    fprintf(stderr, "fxcachesim: unknown model '%s'\n", m.c_str());
+                    return 2;
+                }
+                const Result r = replay(trace, *model, ps, tag);
+                const double hit = r.accesses ? 100.0 * (double)r.hits / (double)r.accesses : 0.0;
+                const double spf = frames ? (double)r.seeks / (double)frames : 0.0;
+                printf("%-5s %6u %5u %7.2f%% %10llu %12llu %11.3f %12llu %8u\n",
+                       m.c_str(), ps, n, hit, (unsigned long long)r.seeks,
+                       (unsigned long long)r.bytes, spf, (unsigned long long)r.worst_bytes,
+                       r.worst_frame);
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,439 @@
+// Packs fxdata.bin into the paged container read by FX (lib/include/FxPack.h)
+// and compares it with the plain file.
+//
+// Build (host):
+//   c++ -std=c++17 -O2 -o fxpack tools/fxpack/fxpack.cpp
+//
+// Usage:
+//   fxpack pack  [-p page] [-l depth] fxdata.bin fxdata.fxpk
+//   fxpack bench [-p page] [-l depth] [-n pages] [-t fxtrace.bin]
+//                [--seek-us N] [--kbps N] [--cpu-scale N] fxdata.bin
+//
+// `bench` replays an FX access trace (ARDULIB_FX_TRACE) through an LRU cache
+// the size of FX's, or touches every page once without a trace, and reports
+// SD bytes read and miss latency for the plain and packed files. A miss costs
+// one seek plus the bytes read at the given SD throughput; packed misses also
+// pay the decode time measured on this host, multiplied by --cpu-scale to
+// approximate the target CPU. The defaults are rough Flipper Zero figures;
+// measure on the device and pass your own when it matters.
+//
+// Install a container by copying it over assets/POA/fxdata.bin: FX detects
+// the header and decodes pages as they are loaded into the cache.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../../lib/include/FxPack.h"
+#include "../../lib/include/FxTrace.h"
+
+namespace {
+
+// ---------------------------------------------------------------------------
+// LZ4 block encoder, one page at a time. Hash chains over 4-byte prefixes;
+// `depth` bounds the candidates tried per position.
+
+constexpr uint32_t kMinMatch = 4;
+constexpr uint32_t kLastLiterals = 5; // LZ4: the block ends with >= 5 literals
+constexpr uint32_t kMatchLimit = 12; // LZ4: no match starts in the last 12 bytes
+constexpr uint32_t kMaxOffset = 0xFFFF;
+constexpr uint32_t kHashBits = 12;
+
+uint32_t hash4(const uint8_t* p) {
+    uint32_t v;
+    memcpy(&v, p, 4);
+    return (v * 2654435761u) >> (32 - kHashBits);
+}
+
+void putLength(std::vector<uint8_t>& out, size_t len) {
+    while(len >= 255) {
+        out.push_back(255);
+        len -= 255;
+    }
+    out.push_back((uint8_t)len);
+}
+
+void putSequence(std::vector<uint8_t>& out, const uint8_t* lit, size_t lit_len, size_t off, size_t match_len) {
+    const size_t ml = match_len ? match_len - kMinMatch : 0;
+    out.push_back((uint8_t)(((lit_len < 15 ? lit_len : 15) << 4) | (ml < 15 ? ml : 15)));
+    if(lit_len >= 15) putLength(out, lit_len - 15);
+    out.insert(out.end(), lit, lit + lit_len);
+    if(!match_len) return;
+    out.push_back((uint8_t)off);
+    out.push_back((uint8_t)(off >> 8));
+    if(ml >= 15) putLength(out, ml - 15);
+}
+
+std::vector<uint8_t> compressPage(const uint8_t* src, size_t n, int depth) {
+    std::vector<uint8_t> out;
+    std::vector<int32_t> head(1u << kHashBits, -1);
+    std::vector<int32_t> chain(n, -1);
+
+    size_t anchor = 0;
+    size_t i = 0;
+    const size_t match_end = n > kLastLiterals ? n - kLastLiterals : 0;
+    const size_t search_end = n > kMatchLimit ? n - kMatchLimit : 0;
+
+    auto insert = [&](size_t pos) {
+        const uint32_t h = hash4(src + pos);
+        chain[pos] = head[h];
+        head[h] = (int32_t)pos;
+    };
+
+    while(i < search_end) {
+        size_t best_len = 0;
+        size_t best_off = 0;
+        int32_t cand = head[hash4(src + i)];
+        for(int d = 0; d < depth && cand >= 0 && i - (size_t)cand <= kMaxOffset; d++, cand = chain[cand]) {
+            size_t len = 0;
+            while(i + len < match_end && src[cand + len] == src[i + len])
+                len++;
+            if(len > best_len) {
+                best_len = len;
+                best_off = i - (size_t)cand;
+            }
+        }
+
+        if(best_len < kMinMatch) {
+            insert(i);
+            i++;
+            continue;
+        }
+
+        putSequence(out, src + anchor, i - anchor, best_off, best_len);
+        for(size_t k = 0; k < best_len && i + k < search_end; k++)
+            insert(i + k);
+        i += best_len;
+        anchor = i;
+    }
+    putSequence(out, src + anchor, n - anchor, 0, 0);
+    return out;
+}
+
+// ---------------------------------------------------------------------------
+
+struct Packed {
+    uint32_t page_size = 0;
+    std::vector<uint8_t> file;
+    std::vector<uint32_t> index;
+    uint32_t stored_raw = 0;
+};
+
+uint32_t rawLen(const std::vector<uint8_t>& data, uint32_t page_size, uint32_t i) {
+    const size_t start = (size_t)i * page_size;
+    return (uint32_t)std::min<size_t>(page_size, data.size() - start);
+}
+
+void putLe32(std::vector<uint8_t>& v, size_t at, uint32_t x) {
+    v[at] = (uint8_t)x;
+    v[at + 1] = (uint8_t)(x >> 8);
+    v[at + 2] = (uint8_t)(x >> 16);
+    v[at + 3] = (uint8_t)(x >> 24);
+}
+
+Packed pack(const std::vector<uint8_t>& data, uint32_t page_size, int depth) {
+    Packed p;
+    p.page_size = page_size;
+    const uint32_t pages = (uint32_t)((data.size() + page_size - 1) / page_size);
+
+    const size_t header = FX_PACK_HEADER_SIZE + 4u * ((size_t)pages + 1u);
+    p.file.assign(header, 0);
+    memcpy(p.file.data(), FX_PACK_MAGIC, 4);
+    p.file[4] = FX_PACK_VERSION;
+    p.file[5] = FX_PACK_CODEC_LZ4;
+    p.file[6] = (uint8_t)page_size;
+    p.file[7] = (uint8_t)(page_size >> 8);
+    putLe32(p.file, 8, (uint32_t)data.size());
+    putLe32(p.file, 12, pages);
+
+    for(uint32_t i = 0; i < pages; i++) {
+        p.index.push_back((uint32_t)p.file.size());
+        const uint8_t* src = data.data() + (size_t)i * page_size;
+        const uint32_t raw = rawLen(data, page_size, i);
+        std::vector<uint8_t> z = compressPage(src, raw, depth);
+        if(z.size() >= raw) {
+            p.file.insert(p.file.end(), src, src + raw);
+            p.stored_raw++;
+        } else {
+            p.file.insert(p.file.end(), z.begin(), z.end());
+        }
+    }
+    p.index.push_back((uint32_t)p.file.size());
+    for(uint32_t i = 0; i <= pages; i++)
+        putLe32(p.file, FX_PACK_HEADER_SIZE + 4u * i, p.index[i]);
+    return p;
+}
+
+uint32_t storedLen(const Packed& p, uint32_t i) {
+    return p.index[i + 1] - p.index[i];
+}
+
+// Decodes page i the way FX::dataReadPage_ does.
+bool unpackPage(const Packed& p, const std::vector<uint8_t>& data, uint32_t i, uint8_t* out) {
+    const uint32_t raw = rawLen(data, p.page_size, i);
+    const uint32_t stored = storedLen(p, i);
+    const uint8_t* src = p.file.data() + p.index[i];
+    if(stored == raw) {
+        memcpy(out, src, raw);
+        return true;
+    }
+    return fx_pack_decode(src, stored, out, raw) == raw;
+}
+
+bool verify(const Packed& p, const std::vector<uint8_t>& data) {
+    std::vector<uint8_t> buf(p.page_size);
+    for(uint32_t i = 0; i + 1 < p.index.size(); i++) {
+        const uint32_t raw = rawLen(data, p.page_size, i);
+        if(!unpackPage(p, data, i, buf.data()) ||
+           memcmp(buf.data(), data.data() + (size_t)i * p.page_size, raw) != 0) {
+            fprintf(stderr, "fxpack: page %u does not round-trip\n", i);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Host decode time per page in microseconds, best of a few runs.
+std::vector<double> timeDecode(const Packed& p, const std::vector<uint8_t>& data) {
+    const uint32_t pages = (uint32_t)p.index.size() - 1u;
+    std::vector<double> us(pages, 0.0);
+    std::vector<uint8_t> buf(p.page_size);
+    constexpr int kReps = 200;
+    for(uint32_t i = 0; i < pages; i++) {
+        const uint32_t raw = rawLen(data, p.page_size, i);
+        if(storedLen(p, i) == raw) continue;
+        double best = 1e30;
+        for(int r = 0; r < 3; r++) {
+            const auto t0 = std::chrono::steady_clock::now();
+            for(int k = 0; k < kReps; k++) {
+                unpackPage(p, data, i, buf.data());
+                __asm__ __volatile__("" : : "r"(buf.data()) : "memory");
+            }
+            const auto t1 = std::chrono::steady_clock::now();
+            best = std::min(best, std::chrono::duration<double, std::micro>(t1 - t0).count() / kReps);
+        }
+        us[i] = best;
+    }
+    return us;
+}
+
+// ---------------------------------------------------------------------------
+
+bool readFile(const char* path, std::vector<uint8_t>& out) {
+    FILE* f = fopen(path, "rb");
+    if(!f) {
+        fprintf(stderr, "fxpack: cannot open %s\n", path);
+        return false;
+    }
+    uint8_t buf[65536];
+    size_t r;
+    while((r = fread(buf, 1, sizeof(buf), f)) > 0)
+        out.insert(out.end(), buf, buf + r);
+    fclose(f);
+    return true;
+}
+
+bool loadTrace(const char* path, std::vector<std::pair<uint32_t, uint32_t>>& out) {
+    std::vector<uint8_t> t;
+    if(!readFile(path, t)) return false;
+    if(t.size() < FX_TRACE_HEADER_SIZE || memcmp(t.data(), FX_TRACE_MAGIC, 4) != 0 ||
+       t[4] != FX_TRACE_VERSION || t[5] != FX_TRACE_RECORD_SIZE) {
+        fprintf(stderr, "fxpack: %s is not an FX trace (v%d)\n", path, FX_TRACE_VERSION);
+        return false;
+    }
+    for(size_t i = FX_TRACE_HEADER_SIZE; i + FX_TRACE_RECORD_SIZE <= t.size(); i += FX_TRACE_RECORD_SIZE) {
+        const uint8_t* r = t.data() + i;
+        const uint32_t addr = (uint32_t)r[0] | ((uint32_t)r[1] << 8) | ((uint32_t)r[2] << 16);
+        const uint32_t len = (uint32_t)r[3] | ((uint32_t)r[4] << 8);
+        out.emplace_back(addr, len ? len : 1u);
+    }
+    return true;
+}
+
+// Page numbers that miss in an LRU cache of `capacity` pages.
+std::vector<uint32_t> lruMisses(const std::vector<std::pair<uint32_t, uint32_t>>& trace,
+                                uint32_t page_size, uint32_t pages, size_t capacity) {
+    std::vector<uint32_t> misses;
+    std::list<uint32_t> lru;
+    std::unordered_map<uint32_t, std::list<uint32_t>::iterator> map;
+    for(const auto& a : trace) {
+        const uint32_t first = a.first / page_size;
+        const uint32_t last = std::min((a.first + a.second - 1u) / page_size, pages - 1u);
+        for(uint32_t p = first; p <= last; p++) {
+            auto it = map.find(p);
+            if(it != map.end()) {
+                lru.splice(lru.begin(), lru, it->second);
+                continue;
+            }
+            if(lru.size() == capacity) {
+                map.erase(lru.back());
+                lru.pop_back();
+            }
+            lru.push_front(p);
+            map[p] = lru.begin();
+            misses.push_back(p);
+        }
+    }
+    return misses;
+}
+
+struct Latency {
+    uint64_t bytes = 0;
+    double mean = 0;
+    double p95 = 0;
+    double max = 0;
+};
+
+Latency summarize(std::vector<double>& us, uint64_t bytes) {
+    Latency l;
+    l.bytes = bytes;
+    if(us.empty()) return l;
+    double sum = 0;
+    for(double v : us)
+        sum += v;
+    std::sort(us.begin(), us.end());
+    l.mean = sum / (double)us.size();
+    l.p95 = us[std::min(us.size() - 1, (size_t)((double)us.size() * 0.95))];
+    l.max = us.back();
+    return l;
+}
+
+void usage() {
+    fprintf(stderr,
+            "usage: fxpack pack  [-p page] [-l depth] fxdata.bin out.fxpk\n"
+            "       fxpack bench [-p page] [-l depth] [-n pages] [-t fxtrace.bin]\n"
+            "                    [--seek-us N] [--kbps N] [--cpu-scale N] fxdata.bin\n"
+            "  -p           container page size, a power of two that divides the FX cache\n"
+            "               page (default 1024)\n"
+            "  -l           match candidates tried per position (default 32)\n"
+            "  -n           cache pages for the trace replay (default 30)\n"
+            "  -t           replay this trace instead of touching every page once\n"
+            "  --seek-us    fixed cost of one SD read request (default 600)\n"
+            "  --kbps       SD read throughput in KiB/s (default 500)\n"
+            "  --cpu-scale  target/host decode time ratio (default 40)\n");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if(argc < 2) {
+        usage();
+        return 2;
+    }
+    const std::string mode = argv[1];
+    uint32_t page_size = 1024;
+    int depth = 32;
+    size_t cache_pages = 30;
+    const char* trace_path = nullptr;
+    double seek_us = 600.0;
+    double kbps = 500.0;
+    double cpu_scale = 40.0;
+    std::vector<const char*> files;
+
+    for(int i = 2; i < argc; i++) {
+        const bool has_arg = (i + 1 < argc);
+        if(!strcmp(argv[i], "-p") && has_arg)
+            page_size = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        else if(!strcmp(argv[i], "-l") && has_arg)
+            depth = atoi(argv[++i]);
+        else if(!strcmp(argv[i], "-n") && has_arg)
+            cache_pages = strtoul(argv[++i], nullptr, 10);
+        else if(!strcmp(argv[i], "-t") && has_arg)
+            trace_path = argv[++i];
+        else if(!strcmp(argv[i], "--seek-us") && has_arg)
+            seek_us = atof(argv[++i]);
+        else if(!strcmp(argv[i], "--kbps") && has_arg)
+            kbps = atof(argv[++i]);
+        else if(!strcmp(argv[i], "--cpu-scale") && has_arg)
+            cpu_scale = atof(argv[++i]);
+        else if(argv[i][0] == '-') {
+            usage();
+            return 2;
+        } else
+            files.push_back(argv[i]);
+    }
+    if(page_size < 256 || page_size > 0xFFFF || (page_size & (page_size - 1)) || depth < 1 ||
+       cache_pages < 1 || (mode == "pack" && files.size() != 2) ||
+       (mode == "bench" && files.size() != 1) || (mode != "pack" && mode != "bench")) {
+        usage();
+        return 2;
+    }
+
+    std::vector<uint8_t> data;
+    if(!readFile(files[0], data)) return 1;
+    if(data.empty()) {
+        fprintf(stderr, "fxpack: %s is empty\n", files[0]);
+        return 1;
+    }
+
+    const Packed p = pack(data, page_size, depth);
+    if(!verify(p, data)) return 1;
+    const uint32_t pages = (uint32_t)p.index.size() - 1u;
+    const size_t index_bytes = FX_PACK_HEADER_SIZE + 4u * ((size_t)pages + 1u);
+
+    printf("%s: %zu bytes, %u pages of %u\n", files[0], data.size(), pages, page_size);
+    printf("packed: %zu bytes (%.1f%%), %u pages stored raw, %zu bytes header + index\n",
+           p.file.size(), 100.0 * (double)p.file.size() / (double)data.size(), p.stored_raw,
+           index_bytes);
+
+    if(mode == "pack") {
+        FILE* f = fopen(files[1], "wb");
+        if(!f || fwrite(p.file.data(), 1, p.file.size(), f) != p.file.size()) {
+            fprintf(stderr, "fxpack: cannot write %s\n", files[1]);
+            if(f) fclose(f);
+            return 1;
+        }
+        fclose(f);
+        printf("wrote %s\n", files[1]);
+        return 0;
+    }
+
+    std::vector<uint32_t> misses;
+    if(trace_path) {
+        std::vector<std::pair<uint32_t, uint32_t>> trace;
+        if(!loadTrace(trace_path, trace)) return 1;
+        misses = lruMisses(trace, page_size, pages, cache_pages);
+        printf("workload: %s, %zu reads, LRU %zu x %u -> %zu misses\n", trace_path, trace.size(),
+               cache_pages, page_size, misses.size());
+    } else {
+        for(uint32_t i = 0; i < pages; i++)
+            misses.push_back(i);
+        printf("workload: every page once -> %zu misses\n", misses.size());
+    }
+
+    const std::vector<double> decode = timeDecode(p, data);
+    const double us_per_byte = 1e6 / (kbps * 1024.0);
+
+    std::vector<double> plain_us, packed_us;
+    uint64_t plain_bytes = 0, packed_bytes = 0;
+    double decode_host = 0;
+    for(uint32_t m : misses) {
+        const uint32_t raw = rawLen(data, page_size, m);
+        const uint32_t stored = storedLen(p, m);
+        plain_bytes += raw;
+        packed_bytes += stored;
+        decode_host += decode[m];
+        plain_us.push_back(seek_us + raw * us_per_byte);
+        packed_us.push_back(seek_us + stored * us_per_byte + decode[m] * cpu_scale);
+    }
+
+    const Latency a = summarize(plain_us, plain_bytes);
+    const Latency b = summarize(packed_us, packed_bytes);
+    printf("model: %.0f us/request, %.0f KiB/s, decode x%.0f (host decode %.2f us/miss)\n\n",
+           seek_us, kbps, cpu_scale, misses.empty() ? 0.0 : decode_host / (double)misses.size());
+    printf("%-7s %12s %10s %12s %12s %12s\n", "file", "bytes read", "per miss", "mean us", "p95 us",
+           "max us");
+    const double n = misses.empty() ? 1.0 : (double)misses.size();
+    printf("%-7s %12llu %10.0f %12.1f %12.1f %12.1f\n", "plain", (unsigned long long)a.bytes,
+           (double)a.bytes / n, a.mean, a.p95, a.max);
+    printf("%-7s %12llu %10.0f %12.1f %12.1f %12.1f\n", "packed", (unsigned long long)b.bytes,
+           (double)b.bytes / n, b.mean, b.p95, b.max);
+    return 0;
+}